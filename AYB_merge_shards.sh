@@ -0,0 +1,64 @@
+#!/bin/bash
+# Merge AYB sequence outputs of tile shards called with the clusterrange option.
+# Shard files are named with a cluster range tag, {name}c{first}-{last}.{tag}, and are
+# concatenated in cluster order into {name}{tag}, the name used by an unsharded run.
+# The shards of each output must cover all the clusters of its tile, from one to the tile's
+# cluster count, without gaps or overlaps; the last shard may end beyond the tile.
+# Compressed shards are concatenated as they are and decompress to the unsharded output.
+# Arguments: shard directory, tile cluster count, optional output directory [default: shard
+# directory]. The cluster count is either a number used for every output, or a file with
+# a line '{merged name} {count}' for each output, e.g. 's_2_0001.fastq 350000'.
+
+if [ $# -lt 2 ] || [ $# -gt 3 ] || [ ! -d "$1" ]; then
+    echo "Usage: $(basename $0) <shard directory> <cluster count | count file> [<output directory>]" >&2
+    exit 1
+fi
+INDIR=$1
+COUNTS=$2
+OUTDIR=${3:-$1}
+if ! [[ "$COUNTS" =~ ^[0-9]+$ ]] && [ ! -f "$COUNTS" ]; then
+    echo "Cluster count is not a number or a file: $COUNTS" >&2
+    exit 1
+fi
+mkdir -p "$OUTDIR" || exit 1
+
+STATUS=0
+# list each shard as: merged name, first, last, file; sorted by merged name then first cluster
+SHARDS=$(cd "$INDIR" && ls | sed -n -E 's/^(.*)c([0-9]+)-([0-9]+)\.(.+)$/\1\4 \2 \3 &/p' | sort -k1,1 -k2,2n)
+if [ -z "$SHARDS" ]; then
+    echo "No shard files found in $INDIR" >&2
+    exit 1
+fi
+
+for NAME in $(echo "$SHARDS" | cut -d ' ' -f 1 | uniq); do
+    if [[ "$COUNTS" =~ ^[0-9]+$ ]]; then
+        NCLUSTER=$COUNTS
+    else
+        NCLUSTER=$(awk -v name="$NAME" '$1 == name {print $2; exit}' "$COUNTS")
+        if ! [[ "$NCLUSTER" =~ ^[0-9]+$ ]]; then
+            echo "No cluster count for $NAME in $COUNTS" >&2
+            STATUS=1
+            continue
+        fi
+    fi
+    NEXT=1
+    FILES=()
+    while read -r OUT FIRST LAST FILE; do
+        if [ "$FIRST" -ne "$NEXT" ]; then
+            echo "Shards of $NAME do not continue from cluster $NEXT: $FILE" >&2
+            STATUS=1
+            continue 2
+        fi
+        FILES+=("$INDIR/$FILE")
+        NEXT=$((LAST + 1))
+    done < <(echo "$SHARDS" | awk -v name="$NAME" '$1 == name')
+    if [ "$NEXT" -le "$NCLUSTER" ]; then
+        echo "Shards of $NAME end at cluster $((NEXT - 1)) of $NCLUSTER" >&2
+        STATUS=1
+        continue
+    fi
+
+    cat "${FILES[@]}" > "$OUTDIR/$NAME" || STATUS=1
+    echo "Merged ${#FILES[@]} shard(s) into $OUTDIR/$NAME"
+done
+exit $STATUS
@@ -37,11 +37,23 @@ SEP=ow
 echo "AYB module test results  " $(date +"%d %B %Y %H:%M")
 echo ""
 
+MODULE=call_bases
+echo "Testing $MODULE"
+# no arguments
+$BIN/test-$MODULE >$OUTDIR/$MODULE.$LOGEXT  2>$OUTDIR/$ERRFILE.$LOGEXT
+diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
+
 MODULE=cluster
 echo "Testing $MODULE"
 # arguments ncycle _int.txt_filename [cif_filename]
 #$BIN/test-$MODULE $NC $INDIR/$ININT >$OUTDIR/$MODULE.$LOGEXT  2>$OUTDIR/$ERRFILE.$LOGEXT
-$BIN/test-$MODULE $NC $INDIR/$ININT $INDIR/$INCIF >$OUTDIR/$MODULE.$LOGEXT  2>$OUTDIR/$ERRFILE.$LOGEXT
+$BIN/test-$MODULE $NC $INDIR/$ININT $INDIR/$INCIF >$OUTDIR/$MODULE.$LOGEXT  2>>$OUTDIR/$ERRFILE.$LOGEXT
+diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
+
+MODULE=libayb
+echo "Testing $MODULE"
+# arguments cif_filename
+$BIN/test-$MODULE $INDIR/$INCIF >$OUTDIR/$MODULE.$LOGEXT  2>>$OUTDIR/$ERRFILE.$LOGEXT
 diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
 
 MODULE=matrix
@@ -114,6 +126,12 @@ diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
 # cpmpare outfile to infile - will be identical if ncycle matches infile
 diff -q -s $INDIR/$INSPIKE $OUTDIR/$OUTSPIKE
 
+MODULE=statistics
+echo "Testing $MODULE"
+# no arguments; arguments nobs filename for the regression test
+$BIN/test-$MODULE >$OUTDIR/$MODULE.$LOGEXT 2>>$OUTDIR/$ERRFILE.$LOGEXT
+diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
+
 MODULE=tile
 echo "Testing $MODULE"
 # arguments ncycle _int.txt_filename [cif_filename run-folder lane_tile_range]
@@ -128,6 +146,20 @@ echo "Testing $MODULE"
 $BIN/test-$MODULE $SEP $INDIR/$INTOK $OUTDIR/$OUTXIO >$OUTDIR/$MODULE.$LOGEXT 2>>$OUTDIR/$ERRFILE.$LOGEXT
 diff -q -s $OUTDIR/$MODULE.$LOGEXT $REFDIR/$MODULE.$REFEXT
 
+# call the cif test tile in double and mixed precision and count the calls and qualities that agree
+echo "Checking precision concordance"
+for PREC in double mixed; do
+    $BIN/AYB -P $PREC -i $INDIR -o $OUTDIR/$PREC -e $OUTDIR/$PREC.$LOGEXT ${INCIF%.cif} >/dev/null 2>>$OUTDIR/$ERRFILE.$LOGEXT
+done
+paste $OUTDIR/double/${INCIF%.cif}.fastq $OUTDIR/mixed/${INCIF%.cif}.fastq | awk -F '\t' '
+    NR % 4 == 2 || NR % 4 == 0 {
+        k = (NR % 4 == 2) ? "Calls" : "Qualities";
+        for (i = 1; i <= length($1); i++) { n[k]++; same[k] += (substr($1, i, 1) == substr($2, i, 1)); }
+    }
+    END { printf "Calls identical: %d of %d\nQualities identical: %d of %d\n", same["Calls"], n["Calls"], same["Qualities"], n["Qualities"]; }
+' >$OUTDIR/precision.$LOGEXT
+diff -s $OUTDIR/precision.$LOGEXT $REFDIR/precision.$REFEXT
+
 # compare the error output file
 echo "Checking program messages"
 diff -s $OUTDIR/$ERRFILE.$LOGEXT $REFDIR/$ERRFILE.$REFEXT
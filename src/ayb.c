@@ -46,6 +46,22 @@
 #include "statistics.h"
 
 
+/**
+ * Temporary storage reused by every iteration of a tile block, owned by the AYB structure.
+ * Matrices are allocated on first use and then kept, so steady state iterations do not allocate.
+ * Per-thread arrays have one entry for each available thread.
+ */
+struct WorkSpaceT {
+    int ncpu;
+    MAT J, K, Sbar, Ibar, lhs, rhs;         // parameter estimation terms
+    MAT x0;                                 // conjugate gradient starting solution
+    MAT * part;                             // per-thread dense accumulation (lda x lda)
+    MAT * panel;                            // per-thread weighted residual panels
+    MAT * pcl_int;                          // per-thread processed intensities
+    real_t ** band;                         // per-thread compact covariance bands
+};
+typedef struct WorkSpaceT * WORKSPACE;
+
 /** AYB structure contains the data required for modelling. */
 struct AybT {
     uint_fast32_t ncluster;
@@ -62,6 +78,10 @@ struct AybT {
     MAT we, cycle_var;
     MAT omega;
     bool *spiked, *notthinned;
+    bool spikefound;
+    bool callonly;
+    WORKSPACE ws;
+    unsigned int nsolve, nsolveiter, nfallback; // conjugate gradient solves, iterations and fallbacks to report
 };
 
 /** Structure for spike-in quality counts. */
@@ -93,12 +113,72 @@ static const char *SHOWWORK_TEXT[] = {
         "processed",
         ""};
 
+/** Enumeration for warm start of model parameters from previous tiles. */
+typedef enum { E_WARM_NULL, E_WARM_PREVIOUS, E_WARM_AVERAGE, E_WARM_NUM} WARMSTART;
+
+/**
+ * Warm start text. Used to match program argument and as text in log file.
+ * Ensure list matches WARMSTART enum.
+ */
+static const char *WARMSTART_TEXT[] = {
+        "none",
+        "previous",
+        "average",
+        ""};
+
+/** Enumeration for floating point precision of base calling. */
+typedef enum { E_PREC_DOUBLE, E_PREC_MIXED, E_PREC_NUM} PRECISION;
+
+/**
+ * Precision text. Used to match program argument and as text in log file.
+ * Ensure list matches PRECISION enum.
+ */
+static const char *PRECISION_TEXT[] = {
+        "double",
+        "mixed",
+        ""};
+
+/** Enumeration for solver of the parameter estimation equations. */
+typedef enum { E_SOLVER_CHOL, E_SOLVER_PCG, E_SOLVER_NUM} SOLVER;
+
+/**
+ * Solver text. Used to match program argument and as text in log file.
+ * Ensure list matches SOLVER enum.
+ */
+static const char *SOLVER_TEXT[] = {
+        "cholesky",
+        "pcg",
+        ""};
+
+/**
+ * Converged model parameters kept for use by later tiles, one per data block.
+ * Used for warm start of the next tile and for lane level estimation.
+ * At is stored transposed as used in the model. Only valid for tiles of the same lane.
+ */
+struct ParamT {
+    unsigned int lane;
+    unsigned int blk;
+    unsigned int ntile;
+    real_t effdf;
+    MAT At, N, omega, cycle_var;
+};
+
 
 /* constants */
 
 static const unsigned int AYB_NITER = 20;       ///< Number of parameter estimation loops.
 static const real_t DELTA_DIAG = 1.0;           ///< Delta for solver routines.
 static const real_t RIDGE_VAL = 100000.0;       ///< At and N solver constant.
+static const real_t PCG_TOL = 1e-10;            ///< Conjugate gradient solver relative residual tolerance.
+static const int PCG_MAXITER = 100;             ///< Conjugate gradient solver iterations before using Cholesky.
+static const unsigned int THIN_NBRIGHT = 8;     ///< Number of brightness strata for thinning to target.
+static const unsigned int THIN_NPOS = 8;        ///< Number of position strata for thinning to target.
+static const uint_fast32_t COV_PANEL = 64;      ///< Clusters per panel for full covariance accumulation.
+static const char BUNDLE_ID[8] = "AYBparam";    ///< Identifier at the start of a parameter bundle file.
+static const uint32_t BUNDLE_VERSION = 1;       ///< Parameter bundle format version.
+static const uint32_t BUNDLE_ORDER = 0x01020304;///< Byte order marker of a parameter bundle.
+static const char *BUNDLE_TAG = "param";        ///< Output file tag for a parameter bundle.
+static const char BUNDLE_SEP = ',';             ///< Separator of parameter bundle file paths.
 
 /** Initial Crosstalk matrix if not read in, fixed values of approximately the right shape. */
 static const real_t INITIAL_CROSSTALK[] = {
@@ -117,60 +197,152 @@ static MAT Matrix[E_MNP];                       ///< Predetermined matrices.
 static SHOWWORK ShowWorking = E_SHOWWORK_NULL;  ///< Set to non-zero to output final working values.
 static unsigned int ThinFact = 1;               ///< Factor to thin out clusters by.
 static unsigned int ZeroThin = 3;               ///< Thin clusters with this or more missing data cycles.
+static unsigned int ThinTarget = 0;             ///< Target number of clusters for parameter estimation, zero for none.
+static unsigned int ThinSeed = 1;               ///< Random seed for thinning to target.
 static bool FixedParam = false;                 ///< Use fixed supplied parameter matrices.
 static bool SpikeIn = false;                    ///< Use spike-in data.
-static bool SpikeFound = false;                 ///< Spike-in data found for this tile block.
 static bool SpikeCalib = false;                 ///< Calibrate qualities using spike-in data.
+static WARMSTART WarmStart = E_WARM_NULL;       ///< Seed model parameters from previous tiles.
+static struct ParamT * Warm = NULL;             ///< Warm start parameters, indexed by data block.
+static unsigned int NWarm = 0;                  ///< Number of data blocks in warm start array.
+static bool LaneFitting = false;                ///< Estimating lane parameters from sampled clusters.
+static bool Provisional = false;                ///< Calling the first cycles of an incomplete tile.
+static struct ParamT * LaneParam = NULL;        ///< Lane estimated parameters, one per lane and data block.
+static unsigned int NLaneParam = 0;             ///< Number of entries in lane parameter array.
+static CSTRING BundleList = NULL;               ///< Parameter bundle file paths supplied.
+static struct ParamT * Bundle = NULL;           ///< Parameters read from bundle files, one per data block.
+static unsigned int NBundle = 0;                ///< Number of entries in parameter bundle array.
+static PRECISION Precision = E_PREC_DOUBLE;     ///< Floating point precision of base calling.
+static SOLVER Solver = E_SOLVER_CHOL;           ///< Solver of the parameter estimation equations.
 
 
 /* private functions */
 
+/** Free a workspace and all the temporary storage it holds. */
+static WORKSPACE free_workspace(WORKSPACE ws) {
+
+    if (NULL == ws) {return NULL;}
+    free_MAT(ws->J);
+    free_MAT(ws->K);
+    free_MAT(ws->Sbar);
+    free_MAT(ws->Ibar);
+    free_MAT(ws->lhs);
+    free_MAT(ws->rhs);
+    free_MAT(ws->x0);
+    for (int i = 0; i < ws->ncpu; i++) {
+        if (NULL != ws->part) {free_MAT(ws->part[i]);}
+        if (NULL != ws->panel) {free_MAT(ws->panel[i]);}
+        if (NULL != ws->pcl_int) {free_MAT(ws->pcl_int[i]);}
+        if (NULL != ws->band) {xfree(ws->band[i]);}
+    }
+    xfree(ws->part);
+    xfree(ws->panel);
+    xfree(ws->pcl_int);
+    xfree(ws->band);
+    xfree(ws);
+    return NULL;
+}
+
+/** Create an empty workspace for the current number of threads. Returns NULL if allocation fails. */
+static WORKSPACE new_workspace(void) {
+
+    WORKSPACE ws = calloc(1, sizeof(*ws));
+    if (NULL == ws) {return NULL;}
+
+    ws->ncpu = omp_get_max_threads();
+    ws->part = calloc(ws->ncpu, sizeof(MAT));
+    ws->panel = calloc(ws->ncpu, sizeof(MAT));
+    ws->pcl_int = calloc(ws->ncpu, sizeof(MAT));
+    ws->band = calloc(ws->ncpu, sizeof(real_t *));
+    if ((NULL == ws->part) || (NULL == ws->panel) || (NULL == ws->pcl_int) || (NULL == ws->band)) {
+        ws = free_workspace(ws);
+    }
+    return ws;
+}
+
 /**
- * Accumulate covariance matrix (ncycle * NBASE x ncycle * NBASE).
- * Only lower triangular matrix is accumulated.
- * Note: If V is NULL, the required memory is allocated.
- * - p:        Matrix of processed intensities
- * - lambda:   Brightness of cluster
- * - base:     Current base call
- * - do_full:  Calculate full covariance matrix, or just band suitable for fitting Omega
- * - V:        Covariance matrix used for accumulation
+ * Return the workspace of a model, replacing it if the number of threads has changed.
+ * Returns NULL if allocation fails.
  */
-static MAT  accumulate_covariance( const real_t we, const MAT p, const real_t lambda, const NUC * base, const bool do_full, MAT V) {
-    validate(NULL!=p, NULL);
-    validate(NBASE==p->nrow, NULL);
-    validate(lambda>=0.0, NULL);
+static WORKSPACE get_workspace(AYB ayb) {
 
-    const uint_fast32_t ncycle = p->ncol;
-    const int lda = ncycle * NBASE;
+    if ((NULL == ayb->ws) || (ayb->ws->ncpu != omp_get_max_threads())) {
+        ayb->ws = free_workspace(ayb->ws);
+        ayb->ws = new_workspace();
+    }
+    return ayb->ws;
+}
+
+/** Keep a matrix returned by a calculation in its workspace slot, unless the calculation failed. */
+static void keep_MAT(MAT * slot, const MAT mat) {
 
-    // Allocate memory for V if necessary
-    if (NULL==V) {
-        V = new_MAT(lda, lda);
-        if (NULL==V) { return NULL; }
+    if (NULL != mat) {
+        *slot = mat;
     }
+}
 
-    // Perform accumulation. V += R R^t
-    // Note: R = P - \lambda I_b, where I_b is unit vector with b'th elt = 1
+/**
+ * Convert processed intensities into residuals in place: R = P - lambda I_b,
+ * where I_b is unit vector with b'th elt = 1 for each cycle.
+ */
+HOT_KERNEL static void residual_from_processed(MAT p, const real_t lambda, const NUC * base) {
+
+    const uint_fast32_t ncycle = p->ncol;
     for (uint_fast32_t cy = 0; cy < ncycle; cy++){
         if (!isambig(base[cy])) {
             p->x[cy * NBASE + base[cy]] -= lambda;
         }
     }
-    if ( do_full ){
-        syr(LAPACK_LOWER, &lda, &we, p->x, LAPACK_UNIT, V->x, &lda);
-    } 
-    else {
-        // Only update base*base blocks on the diagonal or immediately above and below it
-        // Update more elements than necessary but excess are ignored later.
-        for ( int i=0 ; i<lda ; i++){
-            for ( int j=i ; j<i+2*NBASE ; j++ ){
-                if(j>=lda){ break; }
-                V->x[i*lda+j] += we * p->x[i] * p->x[j];
-            }
+}
+
+/**
+ * Accumulate the block tridiagonal band of the covariance matrix, V += we R R^t, into a compact array.
+ * Only the lower triangle is accumulated; for each column i the band holds the 2 * NBASE rows
+ * from the start of the cycle block of i, so element (j, i) is at band[i * 2 * NBASE + j - i0],
+ * where i0 is the first row of the cycle block containing i.
+ * - r:        Residuals (length lda)
+ * - band:     Compact band used for accumulation (lda * 2 * NBASE)
+ */
+HOT_KERNEL static void accumulate_band(const real_t we, const real_t * r, const int lda, real_t * band) {
+
+    for (int i = 0; i < lda; i++) {
+        const int i0 = i - i % NBASE;
+        const int jend = (i0 + 2 * NBASE < lda) ? i0 + 2 * NBASE : lda;
+        real_t * bcol = band + i * 2 * NBASE - i0;
+        for (int j = i; j < jend; j++) {
+            bcol[j] += we * r[i] * r[j];
         }
     }
+}
+
+/** Add a compact covariance band into the lower triangle of a full (lda x lda) matrix. */
+static void add_band_to_MAT(const real_t * band, MAT V) {
 
-    return V;
+    const int lda = V->nrow;
+    for (int i = 0; i < lda; i++) {
+        const int i0 = i - i % NBASE;
+        const int jend = (i0 + 2 * NBASE < lda) ? i0 + 2 * NBASE : lda;
+        const real_t * bcol = band + i * 2 * NBASE - i0;
+        for (int j = i; j < jend; j++) {
+            V->x[i * lda + j] += bcol[j];
+        }
+    }
+}
+
+/**
+ * Add the weighted residual columns collected in a panel to a full covariance matrix
+ * with a single rank-k update, V += P P^t. Only the lower triangle is accumulated.
+ * Resets the panel count to zero.
+ */
+static void flush_panel(const MAT panel, uint_fast32_t * npanel, MAT V) {
+
+    if (*npanel == 0) {return;}
+    const int lda = V->nrow;
+    const int k = *npanel;
+    const real_t alpha = 1.0;
+    const real_t beta = 1.0;
+    syrk(LAPACK_LOWER, LAPACK_NOTRANS, &lda, &k, &alpha, panel->x, &lda, &beta, V->x, &lda);
+    *npanel = 0;
 }
 
 /** Calibrate qualities using spike-in data.
@@ -200,7 +372,7 @@ static void calibrate_by_spikein(AYB ayb, const int blk, QSPIKEPTR qspike) {
         const uint_fast32_t ncycle = ayb->ncycle;
 
         for (uint_fast32_t cl = 0; cl < ncluster; cl++) {
-            PHREDCHAR * cl_quals = ayb->quals.elt + cl * ncycle;
+            PHREDCHAR * cl_quals = ayb->quals.elt + (size_t)cl * ncycle;
             for (uint_fast32_t cy = 0; cy < ncycle; cy++){
                 int q = qualint_from_phredchar(cl_quals[cy]);
                 cl_quals[cy] = phredchar_from_quality(qact[q]);
@@ -225,11 +397,7 @@ static void calibrate_by_table(const uint_fast32_t ncycle, const real_t lambda,
 
     if (lambda != 0.0) {
         /* adjust quality values; first and Last bases of read are special cases */
-        qual[0] = adjust_first_quality(qual[0], cl_bases[0], cl_bases[1]);
-        for (uint_fast32_t cy=1; cy<(ncycle-1); cy++) {
-            qual[cy] = adjust_quality(qual[cy], cl_bases[cy-1], cl_bases[cy], cl_bases[cy+1]);
-        }
-        qual[ncycle-1] = adjust_last_quality(qual[ncycle-1], cl_bases[ncycle-2], cl_bases[ncycle-1]);
+        adjust_qualities(ncycle, cl_bases, qual);
     }
 }
 
@@ -340,12 +508,12 @@ static bool read_matrices(void) {
  */
 static void read_spikein_data(AYB ayb, const int blk) {
     
-    SpikeFound = false;
-    if (!SpikeIn) { return; }
     validate(NULL != ayb, );
+    ayb->spikefound = false;
+    if (!SpikeIn) { return; }
     if (!read_spikein_file(ayb->ncycle, blk)) { return; }
 
-    SpikeFound = true;
+    ayb->spikefound = true;
     const uint_fast32_t ncluster = ayb->ncluster;
     const uint_fast32_t ncycle = ayb->ncycle;
 
@@ -354,7 +522,7 @@ static void read_spikein_data(AYB ayb, const int blk) {
         /* store the bases for the given cluster */
         uint_fast32_t cl = spikein->knum;
         if (cl < ncluster) {
-            NUC * cl_bases = ayb->bases.elt + cl * ncycle;
+            NUC * cl_bases = ayb->bases.elt + (size_t)cl * ncycle;
             for (uint_fast32_t cy = 0; cy < ncycle; cy++){
                 cl_bases[cy] = spikein->kbases.elt[cy];
             }
@@ -381,8 +549,8 @@ static void set_null_calls(AYB ayb) {
     unsigned int cl = 0;
     LIST(CLUSTER) node = ayb->tile->clusterlist;
     while (NULL != node && cl < ncluster){
-        NUC * cl_bases = ayb->bases.elt + cl * ncycle;
-        PHREDCHAR * cl_quals = ayb->quals.elt + cl * ncycle;
+        NUC * cl_bases = ayb->bases.elt + (size_t)cl * ncycle;
+        PHREDCHAR * cl_quals = ayb->quals.elt + (size_t)cl * ncycle;
 
         /* call null base for each cycle */
         for (uint_fast32_t cy = 0; cy < ncycle; cy++){
@@ -408,7 +576,7 @@ static void store_cluster_error(AYB ayb, MAT ip, unsigned int cl){
     const uint_fast32_t ncycle = ayb->ncycle;
 
     ayb->we->x[cl] = 0.;
-    NUC * cycle_bases = ayb->bases.elt + cl*ncycle;
+    NUC * cycle_bases = ayb->bases.elt + (size_t)cl*ncycle;
 
     for ( uint_fast32_t i=0 ; i<ncycle ; i++){
         ip->x[i*NBASE+cycle_bases[i]] -= ayb->lambda->x[cl];
@@ -426,19 +594,25 @@ static real_t update_cluster_weights(AYB ayb){
     const bool * allowed = ayb->notthinned;
     real_t sumLSS = 0.;
 
-    /* Calculate weight for each cluster */
+    /* Calculate weight for each cluster; statistics and updates are parallel over clusters */
     real_t meanLSSi = mean(ayb->we->x,allowed,ncluster);
     real_t varLSSi = variance(ayb->we->x,allowed,ncluster);
     if( varLSSi != 0.0){
+        sumLSS = sum(ayb->we->x,allowed,ncluster);
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
         for ( uint_fast32_t cl=0 ; cl<ncluster ; cl++){
             if(!allowed[cl]){ continue; }
-            sumLSS += ayb->we->x[cl];
             const real_t d = ayb->we->x[cl]-meanLSSi;
             ayb->we->x[cl] = cauchy(d*d,varLSSi);
         }
     } 
     else {
         // If variance is zero, set all weights to one.
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
         for ( uint_fast32_t cl=0 ; cl<ncluster ; cl++){
             if(!allowed[cl]){ continue; }
             ayb->we->x[cl] = 1.0;
@@ -450,6 +624,444 @@ static real_t update_cluster_weights(AYB ayb){
     return sumLSS;
 }
 
+/* Functions for thinning to a target number of clusters */
+
+/** Cluster details for stratified thinning. */
+struct ThinT {
+    real_t lambda;
+    uint_fast32_t cl;
+    uint_fast32_t pos;
+};
+
+/** Compare thinning candidates by initial lambda, then by position for a stable order. */
+static int compare_thin(const void *a, const void *b) {
+
+    const struct ThinT * ta = a;
+    const struct ThinT * tb = b;
+    if (ta->lambda < tb->lambda) {return -1;}
+    if (ta->lambda > tb->lambda) {return 1;}
+    return (ta->pos < tb->pos) ? -1 : (ta->pos > tb->pos);
+}
+
+/** Return the next value of a 64 bit pseudo-random generator (splitmix64); same sequence on all platforms. */
+static inline uint64_t next_random(uint64_t *state) {
+
+    uint64_t z = (*state += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+/** Return the thinning stratum for a candidate from its brightness rank and position rank. */
+static inline unsigned int thin_stratum(const uint_fast32_t rank, const uint_fast32_t pos, const uint_fast32_t ncand) {
+    return ((uint64_t)rank * THIN_NBRIGHT / ncand) * THIN_NPOS + (uint64_t)pos * THIN_NPOS / ncand;
+}
+
+/**
+ * Thin the clusters used for parameter estimation to the target number.
+ * Candidates are clusters not already thinned and not spike-in data; spike-ins are always kept.
+ * Strata are quantiles of initial lambda crossed with bands of tile position (cluster order).
+ * Each stratum keeps its proportional share, chosen at random from the seed.
+ * Returns false if memory allocation fails, leaving all candidates in use.
+ */
+static bool thin_to_target(AYB ayb) {
+
+    const uint_fast32_t ncluster = ayb->ncluster;
+    const unsigned int nstrata = THIN_NBRIGHT * THIN_NPOS;
+    bool ret = false;
+
+    uint_fast32_t ncand = 0;
+    for (uint_fast32_t cl = 0; cl < ncluster; cl++) {
+        if (ayb->notthinned[cl] && !ayb->spiked[cl]) {ncand++;}
+    }
+    if (ncand <= ThinTarget) {return true;}
+
+    struct ThinT * cand = malloc(ncand * sizeof(*cand));
+    uint_fast32_t * bucket = malloc(ncand * sizeof(*bucket));
+    uint_fast32_t count[nstrata + 1];       // cumulative, stratum s is count[s] to count[s+1]
+    uint_fast32_t next[nstrata];            // next free position in each bucket
+    memset(count, 0, sizeof(count));
+    if ((NULL == cand) || (NULL == bucket)) {goto cleanup;}
+
+    /* candidates in position order, then sorted by brightness */
+    uint_fast32_t i = 0;
+    for (uint_fast32_t cl = 0; cl < ncluster; cl++) {
+        if (ayb->notthinned[cl] && !ayb->spiked[cl]) {
+            cand[i].lambda = ayb->lambda->x[cl];
+            cand[i].cl = cl;
+            cand[i].pos = i;
+            i++;
+        }
+    }
+    qsort(cand, ncand, sizeof(*cand), compare_thin);
+
+    /* stratum of each candidate from brightness rank and position rank; count sort into buckets */
+    for (i = 0; i < ncand; i++) {
+        count[thin_stratum(i, cand[i].pos, ncand) + 1]++;
+    }
+    for (unsigned int s = 0; s < nstrata; s++) {
+        count[s + 1] += count[s];
+        next[s] = count[s];
+    }
+    for (i = 0; i < ncand; i++) {
+        bucket[next[thin_stratum(i, cand[i].pos, ncand)]++] = cand[i].cl;
+    }
+
+    /* proportional quota for each stratum from cumulative counts; quotas sum to the target */
+    uint64_t state = ThinSeed;
+    for (unsigned int s = 0; s < nstrata; s++) {
+        const uint_fast32_t start = count[s];
+        const uint_fast32_t num = count[s + 1] - start;
+        const uint_fast32_t quota = ((uint64_t)ThinTarget * count[s + 1]) / ncand
+                                  - ((uint64_t)ThinTarget * start) / ncand;
+
+        /* partial shuffle to choose quota clusters at random; thin the remainder */
+        uint_fast32_t * sb = bucket + start;
+        for (uint_fast32_t k = 0; k < quota; k++) {
+            const uint_fast32_t j = k + next_random(&state) % (num - k);
+            const uint_fast32_t tmp = sb[k];
+            sb[k] = sb[j];
+            sb[j] = tmp;
+        }
+        for (uint_fast32_t k = quota; k < num; k++) {
+            ayb->notthinned[sb[k]] = false;
+        }
+    }
+    ret = true;
+
+cleanup:
+    xfree(cand);
+    xfree(bucket);
+    return ret;
+}
+
+/* Functions for stored model parameters */
+
+/** Return index into warm start array for a data block; single block uses first. */
+static inline unsigned int warm_index(const int blk) {
+    return (blk < 0) ? 0 : blk;
+}
+
+/** Free any stored model parameters for a data block. */
+static void clear_param(struct ParamT * param) {
+
+    param->At = free_MAT(param->At);
+    param->N = free_MAT(param->N);
+    param->omega = free_MAT(param->omega);
+    param->cycle_var = free_MAT(param->cycle_var);
+    param->ntile = 0;
+}
+
+/**
+ * Replace any stored model parameters with a copy of those of the supplied model.
+ * Returns false and leaves the store empty if any copy fails.
+ */
+static bool copy_param(struct ParamT * param, const AYB ayb) {
+
+    clear_param(param);
+    param->lane = ayb->tile->lane;
+    param->At = copy_MAT(ayb->At);
+    param->N = copy_MAT(ayb->N);
+    param->omega = copy_MAT(ayb->omega);
+    param->cycle_var = copy_MAT(ayb->cycle_var);
+    if ((NULL == param->At) || (NULL == param->N) || (NULL == param->omega) || (NULL == param->cycle_var)) {
+        clear_param(param);
+        return false;
+    }
+    param->ntile = 1;
+    return true;
+}
+
+/** Return true if stored warm start parameters are from the same lane and the right size for the model. */
+static bool warm_valid(const AYB ayb, const int blk) {
+
+    const unsigned int idx = warm_index(blk);
+    if (idx >= NWarm) {return false;}
+    const struct ParamT * warm = Warm + idx;
+    if (warm->ntile == 0) {return false;}
+    if (warm->lane != ayb->tile->lane) {return false;}
+    return (warm->N->ncol == ayb->ncycle);
+}
+
+/** Update a running average over n values with a new value: mat += (newmat - mat) / n. */
+static void average_into_MAT(MAT mat, const MAT newmat, const unsigned int n) {
+
+    const uint_fast32_t nelt = mat->nrow * mat->ncol;
+    for (uint_fast32_t i = 0; i < nelt; i++) {
+        mat->x[i] += (newmat->x[i] - mat->x[i]) / n;
+    }
+}
+
+/**
+ * Store the converged model parameters of a data block for warm start of the next tile.
+ * Either replaces the stored values or adds to a running average of all previous tiles.
+ * Restarts from this tile if the lane or number of cycles has changed.
+ */
+static void store_warm_param(const AYB ayb, const int blk) {
+
+    const unsigned int idx = warm_index(blk);
+    if (idx >= NWarm) {
+        /* grow the array; new entries are empty */
+        struct ParamT * newwarm = realloc(Warm, (idx + 1) * sizeof(*Warm));
+        if (NULL == newwarm) {return;}
+        memset(newwarm + NWarm, 0, (idx + 1 - NWarm) * sizeof(*Warm));
+        Warm = newwarm;
+        NWarm = idx + 1;
+    }
+    struct ParamT * warm = Warm + idx;
+
+    if ((WarmStart == E_WARM_AVERAGE) && warm_valid(ayb, blk)) {
+        warm->ntile++;
+        average_into_MAT(warm->At, ayb->At, warm->ntile);
+        average_into_MAT(warm->N, ayb->N, warm->ntile);
+        /* average of positive definite block tridiagonal matrices keeps both properties */
+        average_into_MAT(warm->omega, ayb->omega, warm->ntile);
+        average_into_MAT(warm->cycle_var, ayb->cycle_var, warm->ntile);
+    }
+    else {
+        copy_param(warm, ayb);
+    }
+}
+
+/** Store warm start parameters; data blocks modelled concurrently share the store. */
+static void store_warm_start(const AYB ayb, const int blk) {
+
+    #pragma omp critical (warm_store)
+    store_warm_param(ayb, blk);
+}
+
+/**
+ * Replace initial model parameters with those stored from previous tiles.
+ * Fixed parameter matrices are not replaced.
+ * Returns true if stored values were available and used.
+ */
+static bool warm_start(AYB ayb, const int blk) {
+
+    if (!warm_valid(ayb, blk)) {return false;}
+    const struct ParamT * warm = Warm + warm_index(blk);
+
+    if (!FixedParam) {
+        copyinto_MAT(ayb->Initial_At, warm->At);
+        copyinto_MAT(ayb->N, warm->N);
+    }
+    copyinto_MAT(ayb->cycle_var, warm->cycle_var);
+
+    /* fit_omega starts from the existing omega if there is one */
+    free_MAT(ayb->omega);
+    ayb->omega = copy_MAT(warm->omega);
+
+    message(E_WARMSTART_SD, MSG_INFO, WARMSTART_TEXT[WarmStart], warm->ntile);
+    return true;
+}
+
+/** Return the lane estimated parameters for the lane and data block of a model, or NULL if none. */
+static const struct ParamT * find_lane_param(const AYB ayb, const int blk) {
+
+    const unsigned int idx = warm_index(blk);
+    for (unsigned int i = 0; i < NLaneParam; i++) {
+        const struct ParamT * param = LaneParam + i;
+        if ((param->ntile > 0) && (param->lane == ayb->tile->lane) && (param->blk == idx)
+            && (param->N->ncol == ayb->ncycle)) {
+            return param;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Replace initial model parameters with those estimated for the whole lane.
+ * The model is then set to call bases only, with all parameters held fixed.
+ * Returns true if lane parameters were available and used.
+ */
+static bool lane_start(AYB ayb, const int blk) {
+
+    const struct ParamT * param = find_lane_param(ayb, blk);
+    if (NULL == param) {return false;}
+
+    copyinto_MAT(ayb->Initial_At, param->At);
+    copyinto_MAT(ayb->N, param->N);
+    copyinto_MAT(ayb->cycle_var, param->cycle_var);
+    free_MAT(ayb->omega);
+    ayb->omega = copy_MAT(param->omega);
+
+    /* effective degrees of freedom for qualities are from the lane fit */
+    set_MAT(ayb->lss, param->effdf);
+
+    ayb->callonly = true;
+    message(E_LANEPARAM_D, MSG_INFO, param->lane);
+    return true;
+}
+
+/**
+ * Replace initial model parameters with those read from a parameter bundle for the data block.
+ * The model is then set to call bases only, with all parameters held fixed.
+ * Returns true if bundle parameters were available and used.
+ */
+static bool bundle_start(AYB ayb, const int blk) {
+
+    const unsigned int idx = warm_index(blk);
+    const struct ParamT * param = NULL;
+    for (unsigned int i = 0; i < NBundle; i++) {
+        if ((Bundle[i].blk == idx) && (Bundle[i].N->ncol == ayb->ncycle)) {
+            param = Bundle + i;
+            break;
+        }
+    }
+    if (NULL == param) {return false;}
+
+    copyinto_MAT(ayb->Initial_At, param->At);
+    copyinto_MAT(ayb->N, param->N);
+    copyinto_MAT(ayb->cycle_var, param->cycle_var);
+    free_MAT(ayb->omega);
+    ayb->omega = copy_MAT(param->omega);
+    set_MAT(ayb->lss, param->effdf);
+
+    ayb->callonly = true;
+    message(E_BUNDLEPARAM_D, MSG_INFO, idx + 1);
+    return true;
+}
+
+/* Functions for parameter bundles */
+
+/**
+ * Write the fitted parameters of a data block as a binary parameter bundle.
+ * Holds At as used in the model, N, omega as its block tridiagonal band,
+ * the cycle variances and the effective degrees of freedom for qualities.
+ * Values are in native byte order, which is recorded for checking on read.
+ * The lambda scaling of a calling pass is derived from At so is not stored.
+ * Returns false if any write failed.
+ */
+static bool write_param_bundle(XFILE * fp, const AYB ayb, const real_t effDF, const int blk) {
+
+    const uint32_t head[4] = {BUNDLE_VERSION, BUNDLE_ORDER, warm_index(blk), ayb->ncycle};
+    const uint_fast32_t lda = NBASE * ayb->ncycle;
+    const uint_fast32_t width = 3 * NBASE;
+    real_t band[width];
+
+    bool ok = (xfwrite(BUNDLE_ID, sizeof(BUNDLE_ID), 1, fp) == 1)
+              && (xfwrite(head, sizeof(*head), 4, fp) == 4)
+              && (xfwrite(&effDF, sizeof(effDF), 1, fp) == 1)
+              && (xfwrite(ayb->At->x, sizeof(real_t), lda * lda, fp) == lda * lda)
+              && (xfwrite(ayb->N->x, sizeof(real_t), lda, fp) == lda);
+
+    /* each row of omega holds the blocks of the previous, same and next cycle */
+    for (uint_fast32_t i = 0; ok && (i < lda); i++) {
+        const int_fast32_t first = ((int_fast32_t)(i / NBASE) - 1) * NBASE;
+        for (uint_fast32_t k = 0; k < width; k++) {
+            const int_fast32_t j = first + k;
+            band[k] = ((j < 0) || (j >= lda)) ? 0.0 : ayb->omega->x[i * lda + j];
+        }
+        ok = (xfwrite(band, sizeof(real_t), width, fp) == width);
+    }
+    return ok && (xfwrite(ayb->cycle_var->x, sizeof(real_t), ayb->ncycle, fp) == ayb->ncycle);
+}
+
+/**
+ * Read a parameter bundle written by write_param_bundle into empty stored parameters.
+ * Returns false and leaves the store empty if the format, version or byte order
+ * is not recognised or the file is incomplete.
+ */
+static bool read_param_bundle(XFILE * fp, struct ParamT * param) {
+
+    char id[sizeof(BUNDLE_ID)];
+    uint32_t head[4];
+    if ((xfread(id, sizeof(id), 1, fp) != 1) || (memcmp(id, BUNDLE_ID, sizeof(id)) != 0)
+        || (xfread(head, sizeof(*head), 4, fp) != 4) || (head[0] != BUNDLE_VERSION)
+        || (head[1] != BUNDLE_ORDER) || (head[3] < 1)) {
+        return false;
+    }
+
+    const uint_fast32_t ncycle = head[3];
+    const uint_fast32_t lda = NBASE * ncycle;
+    const uint_fast32_t width = 3 * NBASE;
+    real_t band[width];
+
+    param->lane = 0;
+    param->blk = head[2];
+    param->At = new_MAT(lda, lda);
+    param->N = new_MAT(NBASE, ncycle);
+    param->omega = new_MAT(lda, lda);
+    param->cycle_var = new_MAT(ncycle, 1);
+    if ((NULL == param->At) || (NULL == param->N) || (NULL == param->omega) || (NULL == param->cycle_var)) {
+        goto cleanup;
+    }
+
+    if ((xfread(&param->effdf, sizeof(param->effdf), 1, fp) != 1)
+        || (xfread(param->At->x, sizeof(real_t), lda * lda, fp) != lda * lda)
+        || (xfread(param->N->x, sizeof(real_t), lda, fp) != lda)) {
+        goto cleanup;
+    }
+
+    set_MAT(param->omega, 0.0);
+    for (uint_fast32_t i = 0; i < lda; i++) {
+        if (xfread(band, sizeof(real_t), width, fp) != width) {goto cleanup;}
+        const int_fast32_t first = ((int_fast32_t)(i / NBASE) - 1) * NBASE;
+        for (uint_fast32_t k = 0; k < width; k++) {
+            const int_fast32_t j = first + k;
+            if ((j >= 0) && (j < lda)) {
+                param->omega->x[i * lda + j] = band[k];
+            }
+        }
+    }
+    if (xfread(param->cycle_var->x, sizeof(real_t), ncycle, fp) != ncycle) {goto cleanup;}
+
+    param->ntile = 1;
+    return true;
+
+cleanup:
+    clear_param(param);
+    return false;
+}
+
+/**
+ * Read the parameter bundle files supplied, one per data block.
+ * Returns false if any file cannot be opened or read, or repeats a data block.
+ */
+static bool read_bundles(void) {
+
+    const size_t len = strlen(BundleList);
+    char list[len + 1];
+    strcpy(list, BundleList);
+
+    for (char *path = list, *next = NULL; (path != NULL) && (path < list + len); path = next) {
+        next = strchr(path, BUNDLE_SEP);
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        if (*path == '\0') {continue;}
+
+        XFILE *fp = xfopen(path, XFILE_UNKNOWN, "r");
+        if (xfisnull(fp)) {
+            message(E_OPEN_FAIL_SS, MSG_FATAL, "Parameter bundle", path);
+            xfclose(fp);
+            return false;
+        }
+
+        struct ParamT * newbundle = realloc(Bundle, (NBundle + 1) * sizeof(*Bundle));
+        if (NULL == newbundle) {
+            message(E_NOMEM_S, MSG_FATAL, "parameter bundle storage");
+            xfclose(fp);
+            return false;
+        }
+        Bundle = newbundle;
+        memset(Bundle + NBundle, 0, sizeof(*Bundle));
+
+        bool ok = read_param_bundle(fp, Bundle + NBundle);
+        xfclose(fp);
+        for (unsigned int i = 0; ok && (i < NBundle); i++) {
+            ok = (Bundle[i].blk != Bundle[NBundle].blk);
+        }
+        if (!ok) {
+            clear_param(Bundle + NBundle);
+            message(E_BAD_BUNDLE_S, MSG_FATAL, path);
+            return false;
+        }
+        message(E_INPUT_FOUND_SS, MSG_INFO, "parameter bundle", path);
+        NBundle++;
+    }
+    return (NBundle > 0);
+}
+
 /* Functions for final processed intensities output */
 
 /**
@@ -516,8 +1128,8 @@ static void output_final_values(const AYB ayb, const real_t effDF, const int blk
     xfclose(fpfin);
 }
 
-/** Output final model matrices. */
-static void output_final_matrices(const AYB ayb, const int blk) {
+/** Output final model matrices and a parameter bundle of the fitted values. */
+static void output_final_matrices(const AYB ayb, const real_t effDF, const int blk) {
     XFILE *fpfin = NULL;
 
     /* final N, A in input format */
@@ -529,11 +1141,29 @@ static void output_final_matrices(const AYB ayb, const int blk) {
 
     fpfin = open_output_blk("A", blk);
     if (!xfisnull(fpfin)) {
-        /* input A is not transposed */
+        /* input A is not transposed; restore model orientation after writing */
         transpose_inplace(ayb->At);
         write_MAT_to_column_file (fpfin, ayb->At, false);
+        transpose_inplace(ayb->At);
     }
     xfclose(fpfin);
+
+    /*
+     * parameter bundle to call later tiles with the same values;
+     * always replaced, as a bundle holds a single record even if results are concatenated
+     */
+    CSTRING bundlepath = output_path_blk((CSTRING)BUNDLE_TAG, blk);
+    if (bundlepath != NULL) {
+        fpfin = xfopen(bundlepath, XFILE_UNKNOWN, "w");
+        bool ok = !xfisnull(fpfin) && write_param_bundle(fpfin, ayb, effDF, blk);
+        xfclose(fpfin);
+        if (!ok) {
+            /* no partial bundle for a calling node to reject later */
+            message(E_BUNDLE_FAIL_S, MSG_WARN, bundlepath);
+            remove(bundlepath);
+        }
+        free_CSTRING(bundlepath);
+    }
 }
 
 /**
@@ -575,8 +1205,8 @@ AYB new_AYB(const uint_fast32_t ncycle, const uint_fast32_t ncluster){
     ayb->ncycle = ncycle;
     ayb->ncluster = ncluster;
     ayb->tile = new_TILE();
-    ayb->bases = new_ARRAY(NUC)(ncluster*ncycle);
-    ayb->quals = new_ARRAY(PHREDCHAR)(ncluster*ncycle);
+    ayb->bases = new_ARRAY(NUC)((size_t)ncluster*ncycle);
+    ayb->quals = new_ARRAY(PHREDCHAR)((size_t)ncluster*ncycle);
 //    ayb->M = new_MAT(NBASE,NBASE);
 //    ayb->P = new_MAT(ncycle,ncycle);
     ayb->N = new_MAT(NBASE,ncycle);
@@ -590,12 +1220,18 @@ AYB new_AYB(const uint_fast32_t ncycle, const uint_fast32_t ncluster){
     ayb->spiked = calloc(ncluster, sizeof(bool));
     ayb->notthinned = calloc(ncluster,sizeof(bool));
     memset(ayb->notthinned,1,ncluster);
+    ayb->spikefound = false;
+    ayb->callonly = false;
+    ayb->ws = new_workspace();
+    ayb->nsolve = 0;
+    ayb->nsolveiter = 0;
+    ayb->nfallback = 0;
     
     if( NULL==ayb->tile || NULL==ayb->bases.elt || NULL==ayb->quals.elt
 //            || NULL==ayb->M || NULL==ayb->P || NULL==ayb->N
             || NULL==ayb->N || NULL==ayb->At || NULL==ayb->Initial_At
             || NULL==ayb->lambda || NULL==ayb->lss || NULL==ayb->we || NULL==ayb->cycle_var 
-            || NULL==ayb->spiked || NULL==ayb->notthinned){
+            || NULL==ayb->spiked || NULL==ayb->notthinned || NULL==ayb->ws){
         goto cleanup;
     }
 
@@ -623,6 +1259,7 @@ AYB free_AYB(AYB ayb){
     free_MAT(ayb->omega);
     xfree(ayb->spiked);
     xfree(ayb->notthinned);
+    free_workspace(ayb->ws);
     xfree(ayb);
     return NULL;
 }
@@ -631,6 +1268,7 @@ AYB copy_AYB(const AYB ayb){
     if(NULL==ayb){return NULL;}
     AYB ayb_copy = malloc(sizeof(*ayb));
     if(NULL==ayb_copy){ return NULL;}
+    ayb_copy->ws = NULL;
 
     ayb_copy->ncycle = ayb->ncycle;
     ayb_copy->ncluster = ayb->ncluster;
@@ -682,6 +1320,13 @@ AYB copy_AYB(const AYB ayb){
     if(NULL==ayb_copy->notthinned){ goto cleanup;}
     memcpy(ayb_copy->notthinned, ayb->notthinned, ayb->ncluster * sizeof(bool));
 
+    ayb_copy->spikefound = ayb->spikefound;
+    ayb_copy->callonly = ayb->callonly;
+
+    /* temporary storage is not copied */
+    ayb_copy->ws = new_workspace();
+    if(NULL==ayb_copy->ws){ goto cleanup;}
+
     return ayb_copy;
 
 cleanup:
@@ -727,6 +1372,110 @@ void show_AYB(XFILE * fp, const AYB ayb, bool showall){
     xfputc('\n',fp);
 }
 
+/** Write the dimensions and elements of a matrix, which may be null. Returns false if a write failed. */
+static bool write_state_MAT(XFILE * fp, const MAT mat){
+    const uint32_t dim[2] = {(NULL==mat) ? 0 : mat->nrow, (NULL==mat) ? 0 : mat->ncol};
+    if (xfwrite(dim, sizeof(*dim), 2, fp) != 2) { return false;}
+    const size_t nelt = (size_t)dim[0] * dim[1];
+    return (nelt == 0) || (xfwrite(mat->x, sizeof(*mat->x), nelt, fp) == nelt);
+}
+
+/**
+ * Read a matrix written by write_state_MAT into a new matrix, which must have the
+ * same dimensions as like unless like is null.
+ * Returns null if the read failed or did not match.
+ */
+static MAT read_state_MAT(XFILE * fp, const MAT like){
+    uint32_t dim[2];
+    if (xfread(dim, sizeof(*dim), 2, fp) != 2) { return NULL;}
+    if (0==dim[0] || 0==dim[1]) { return NULL;}
+    if (NULL!=like && (dim[0]!=like->nrow || dim[1]!=like->ncol)) { return NULL;}
+    MAT mat = new_MAT(dim[0], dim[1]);
+    if (NULL==mat) { return NULL;}
+    const size_t nelt = (size_t)dim[0] * dim[1];
+    if (xfread(mat->x, sizeof(*mat->x), nelt, fp) != nelt) { return free_MAT(mat);}
+    return mat;
+}
+
+/**
+ * Write the model state of a data block in binary form, as needed to continue
+ * the base calling loop from the end of the last completed iteration.
+ * Returns false if any write failed.
+ */
+bool write_AYB_state(XFILE * fp, const AYB ayb){
+    validate(NULL!=fp,false);
+    validate(NULL!=ayb,false);
+    const uint32_t dim[2] = {ayb->ncycle, ayb->ncluster};
+    const size_t ncall = (size_t)ayb->ncluster * ayb->ncycle;
+
+    return (xfwrite(dim, sizeof(*dim), 2, fp) == 2)
+            && write_state_MAT(fp, ayb->N) && write_state_MAT(fp, ayb->At)
+            && write_state_MAT(fp, ayb->Initial_At) && write_state_MAT(fp, ayb->lambda)
+            && write_state_MAT(fp, ayb->lss) && write_state_MAT(fp, ayb->we)
+            && write_state_MAT(fp, ayb->cycle_var) && write_state_MAT(fp, ayb->omega)
+            && (xfwrite(ayb->bases.elt, sizeof(NUC), ncall, fp) == ncall)
+            && (xfwrite(ayb->spiked, sizeof(bool), ayb->ncluster, fp) == ayb->ncluster)
+            && (xfwrite(ayb->notthinned, sizeof(bool), ayb->ncluster, fp) == ayb->ncluster);
+}
+
+/**
+ * Read a model state written by write_AYB_state into an initialised model of the same size.
+ * The state is read into scratch storage and only copied into the model if the whole read
+ * succeeds, so the model is unchanged on failure.
+ * Returns false if the state could not be read or does not match the model.
+ */
+bool read_AYB_state(XFILE * fp, AYB ayb){
+    validate(NULL!=fp,false);
+    validate(NULL!=ayb,false);
+    uint32_t dim[2];
+    if (xfread(dim, sizeof(*dim), 2, fp) != 2) { return false;}
+    if (dim[0]!=ayb->ncycle || dim[1]!=ayb->ncluster) { return false;}
+
+    /* omega is created by the first iteration so has no model matrix to match */
+    MAT * model[] = {&ayb->N, &ayb->At, &ayb->Initial_At, &ayb->lambda,
+                     &ayb->lss, &ayb->we, &ayb->cycle_var, &ayb->omega};
+    const unsigned int nmat = sizeof(model) / sizeof(*model);
+    MAT scratch[sizeof(model) / sizeof(*model)] = {NULL};
+    const size_t ncall = (size_t)ayb->ncluster * ayb->ncycle;
+    NUC * bases = calloc(ncall, sizeof(NUC));
+    bool * spiked = calloc(ayb->ncluster, sizeof(bool));
+    bool * notthinned = calloc(ayb->ncluster, sizeof(bool));
+
+    bool ok = (NULL!=bases && NULL!=spiked && NULL!=notthinned);
+    for (unsigned int i = 0; ok && i < nmat; i++) {
+        const MAT like = (&ayb->omega==model[i]) ? NULL : *model[i];
+        scratch[i] = read_state_MAT(fp, like);
+        ok = (NULL!=scratch[i]);
+    }
+    ok = ok && (xfread(bases, sizeof(NUC), ncall, fp) == ncall)
+            && (xfread(spiked, sizeof(bool), ayb->ncluster, fp) == ayb->ncluster)
+            && (xfread(notthinned, sizeof(bool), ayb->ncluster, fp) == ayb->ncluster);
+
+    if (ok) {
+        for (unsigned int i = 0; i < nmat; i++) {
+            if (&ayb->omega==model[i]) {
+                free_MAT(ayb->omega);
+                ayb->omega = scratch[i];
+                scratch[i] = NULL;
+            }
+            else {
+                copyinto_MAT(*model[i], scratch[i]);
+            }
+        }
+        memcpy(ayb->bases.elt, bases, ncall * sizeof(NUC));
+        memcpy(ayb->spiked, spiked, ayb->ncluster * sizeof(bool));
+        memcpy(ayb->notthinned, notthinned, ayb->ncluster * sizeof(bool));
+    }
+
+    for (unsigned int i = 0; i < nmat; i++) {
+        free_MAT(scratch[i]);
+    }
+    xfree(bases);
+    xfree(spiked);
+    xfree(notthinned);
+    return ok;
+}
+
 /* access functions */
 
 /** Return array of non-zero lambdas and how many in num. */
@@ -748,6 +1497,11 @@ uint_fast32_t get_AYB_ncluster(const AYB ayb) {
     return ayb->ncluster;
 }
 
+/** Return true if the model calls bases only, with parameters held fixed from lane estimation. */
+bool get_AYB_callonly(const AYB ayb) {
+    return ayb->callonly;
+}
+
 /** Return the number of cycles. */
 uint_fast32_t get_AYB_ncycle(const AYB ayb) {
     return ayb->ncycle;
@@ -758,12 +1512,16 @@ TILE get_AYB_tile(AYB ayb){
     return ayb->tile;
 }
 
-/** Replace any existing tile with the supplied one. */
+/**
+ * Replace any existing tile with the supplied one.
+ * The model views the intensities of the supplied tile without copying them,
+ * so the tile must not be freed while the model is in use.
+ */
 AYB replace_AYB_tile(AYB ayb, const TILE tile) {
 
     /* free any tile memory, is allocated in new_AYB */
     free_TILE(ayb->tile);
-    ayb->tile = copy_TILE(tile);
+    ayb->tile = (NULL == tile) ? NULL : view_append_TILE(NULL, tile, 0, tile->ncycle - 1);
     return ayb;
 }
 
@@ -773,7 +1531,7 @@ void show_AYB_bases(XFILE * fp, const AYB ayb, const uint_fast32_t cl) {
     const uint_fast32_t ncycle = ayb->ncycle;
 
     for (uint_fast32_t cy = 0; cy < ncycle; cy++){
-        show_NUC(fp, ayb->bases.elt[cl * ncycle + cy]);
+        show_NUC(fp, ayb->bases.elt[(size_t)cl * ncycle + cy]);
     }
 }
 
@@ -783,27 +1541,63 @@ void show_AYB_quals(XFILE * fp, const AYB ayb, const uint_fast32_t cl) {
     const uint_fast32_t ncycle = ayb->ncycle;
 
     for (uint_fast32_t cy = 0; cy < ncycle; cy++){
-        show_PHREDCHAR(fp, ayb->quals.elt[cl * ncycle + cy]);
+        show_PHREDCHAR(fp, ayb->quals.elt[(size_t)cl * ncycle + cy]);
+    }
+}
+
+/**
+ * Copy the calls of all clusters into caller arrays of ncluster x ncycle characters,
+ * bases as letters and qualities as phred characters, cluster by cluster.
+ */
+void get_AYB_calls(const AYB ayb, char * bases, char * quals) {
+
+    const size_t ncall = (size_t)ayb->ncluster * ayb->ncycle;
+
+    for (size_t i = 0; i < ncall; i++){
+        bases[i] = char_from_nuc(ayb->bases.elt[i]);
+        const PHREDCHAR pc = ayb->quals.elt[i];
+        /* as output, with minimum if not a printable character */
+        quals[i] = ((pc < MIN_PHRED) || (pc > MAX_PHRED)) ? MIN_PHRED : pc;
     }
 }
 
+/**
+ * Log the conjugate gradient parameter solves since last reported:
+ * number, total iterations and fallbacks to Cholesky. Counts are then reset.
+ */
+void report_AYB_solver(AYB ayb) {
+
+    if ((NULL == ayb) || (ayb->nsolve == 0)) {return;}
+    message(E_SOLVER_DDDF, MSG_INFO, ayb->nsolve, ayb->nsolveiter, ayb->nfallback,
+            100.0 * ayb->nfallback / ayb->nsolve);
+    ayb->nsolve = 0;
+    ayb->nsolveiter = 0;
+    ayb->nfallback = 0;
+}
+
 
 /**
  * Calculate covariance of (processed) residuals.
  * Uses the "fast approach", working with processed intensities.
- * Returns full covariance matrix.
+ * If do_full then weighted residuals are collected into panels of clusters and
+ * accumulated with one rank-k update per panel; otherwise only the block
+ * tridiagonal band needed to fit omega is accumulated, in compact form.
+ * Returns full size covariance matrix, with zero outside the band if not do_full.
  */
 MAT calculate_covariance(AYB ayb, const bool do_full){
 
     validate(NULL != ayb, NULL);
-    unsigned int ncluster = ayb->ncluster;  // need unsigned int for array_from_LIST
+    size_t ncluster = ayb->ncluster;        // need size_t for array_from_LIST
     const uint_fast32_t ncycle = ayb->ncycle;
+    const int lda = ncycle * NBASE;
     const bool * allowed = ayb->notthinned;
 
-    MAT Vsum = NULL;                        // memory allocated in multi-thread accumulate
+    MAT Vsum = NULL;
     real_t wesum = 0.0;
     bool ok = true;
 
+    WORKSPACE ws = get_workspace(ayb);
+    if (NULL == ws) {return NULL;}
     struct structLU AtLU = LUdecomposition(ayb->At);
 
     /* declare variables for multi-threading */
@@ -811,15 +1605,43 @@ MAT calculate_covariance(AYB ayb, const bool do_full){
     int_fast32_t cl;
     NUC * cl_bases = NULL;
     int th_id;                              // thread number
-    const int ncpu = omp_get_max_threads();
-    MAT pcl_int[ncpu];                      // Shell for processed intensities
-    MAT V[ncpu];                            // memory allocated in accumulate
+    const int ncpu = ws->ncpu;
+    MAT * pcl_int = ws->pcl_int;            // Shell for processed intensities
+    MAT * V = ws->part;                     // full accumulation
+    MAT * panel = ws->panel;                // weighted residuals for full accumulation
+    uint_fast32_t npanel[ncpu];             // number of residuals in panel
+    real_t ** band = ws->band;              // compact band accumulation
     real_t wei[ncpu];                       // accumulate by thread determines sum order
     for (int i = 0; i < ncpu; i++) {
-        pcl_int[i] = NULL;
-        V[i] = NULL;
+        npanel[i] = 0;
         wei[i] = 0.0;
     }
+
+    /* storage for each thread, kept in workspace; accumulators reset to zero */
+    for (int i = 0; i < ncpu; i++) {
+        if (do_full) {
+            if (NULL == V[i]) {
+                V[i] = new_MAT(lda, lda);
+            }
+            else {
+                memset(V[i]->x, 0, lda * lda * sizeof(real_t));
+            }
+            if (NULL == panel[i]) {
+                panel[i] = new_MAT(lda, COV_PANEL);
+            }
+            if ((NULL == V[i]) || (NULL == panel[i])) {ok = false;}
+        }
+        else {
+            if (NULL == band[i]) {
+                band[i] = calloc(lda * 2 * NBASE, sizeof(real_t));
+            }
+            else {
+                memset(band[i], 0, lda * 2 * NBASE * sizeof(real_t));
+            }
+            if (NULL == band[i]) {ok = false;}
+        }
+    }
+    if (!ok) {goto cleanup;}
     
     /* make an array of list pointers for multi-threading */
     nodearry = array_from_LIST(CLUSTER)(ayb->tile->clusterlist, &ncluster);
@@ -838,7 +1660,7 @@ MAT calculate_covariance(AYB ayb, const bool do_full){
         if (!allowed[cl]) { continue; }
         th_id = omp_get_thread_num();
 
-        cl_bases = ayb->bases.elt + cl * ncycle;
+        cl_bases = ayb->bases.elt + (size_t)cl * ncycle;
         pcl_int[th_id] = processNew(AtLU, ayb->N, nodearry[cl]->elt->signals, pcl_int[th_id]);
         if (NULL == pcl_int[th_id]) {
             ok = false;
@@ -846,9 +1668,20 @@ MAT calculate_covariance(AYB ayb, const bool do_full){
         else {
 
             /* add this cluster values */
-            V[th_id] = accumulate_covariance(ayb->we->x[cl], pcl_int[th_id], ayb->lambda->x[cl], cl_bases, do_full, V[th_id]);
-            if (NULL == V[th_id]) { 
-                ok = false; 
+            residual_from_processed(pcl_int[th_id], ayb->lambda->x[cl], cl_bases);
+            if (do_full) {
+                /* weighted residual into next panel column; accumulate when panel full */
+                const real_t sqrtwe = sqrt(ayb->we->x[cl]);
+                real_t * pcol = panel[th_id]->x + npanel[th_id] * lda;
+                for (int i = 0; i < lda; i++) {
+                    pcol[i] = sqrtwe * pcl_int[th_id]->x[i];
+                }
+                if (++npanel[th_id] == COV_PANEL) {
+                    flush_panel(panel[th_id], &npanel[th_id], V[th_id]);
+                }
+            }
+            else {
+                accumulate_band(ayb->we->x[cl], pcl_int[th_id]->x, lda, band[th_id]);
             }
 
             /* sum denominator */
@@ -858,15 +1691,20 @@ MAT calculate_covariance(AYB ayb, const bool do_full){
     
     if (ok) {
         /* Accumulate from multi-thread */ 
-        const int lda = V[0]->nrow;
         Vsum = new_MAT(lda, lda);
         if (NULL == Vsum) {
             ok = false;
         }
         else {
             for (int i = 0; i < ncpu; i++) {
-                for (int j = 0; j < lda * lda; j++) {
-                    Vsum->x[j] += V[i]->x[j];
+                if (do_full) {
+                    flush_panel(panel[i], &npanel[i], V[i]);
+                    for (int j = 0; j < lda * lda; j++) {
+                        Vsum->x[j] += V[i]->x[j];
+                    }
+                }
+                else {
+                    add_band_to_MAT(band[i], Vsum);
                 }
                 wesum += wei[i];
             }
@@ -884,10 +1722,6 @@ cleanup:
     }
     
     free_array_LIST(CLUSTER)(nodearry);
-    for (int i = 0; i < ncpu; i++) {
-        free_MAT(pcl_int[i]);
-        free_MAT(V[i]);
-    }
     free_MAT(AtLU.mat);
     xfree(AtLU.piv);
     return Vsum;
@@ -901,7 +1735,7 @@ cleanup:
 int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showdebug) {
 
     validate(NULL != ayb, 0);
-    unsigned int ncluster = ayb->ncluster;  // need unsigned int for array_from_LIST
+    size_t ncluster = ayb->ncluster;        // need size_t for array_from_LIST
     const uint_fast32_t ncycle = ayb->ncycle;
     const bool * allowed = ayb->notthinned;
 
@@ -911,15 +1745,22 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
     real_t effDF = NBASE * ncycle;
     int ret_count = 0;
 
+    WORKSPACE ws = get_workspace(ayb);
+    if (NULL == ws) {
+        set_null_calls(ayb);
+        return DATA_ERR;
+    }
     struct structLU AtLU = LUdecomposition(ayb->At);
+    MAT A = transpose(ayb->At);             // column table for lambda estimation
+    real_t * omtab = NULL;                  // omega band for double precision calling
+    float * omband = NULL;                  // single precision omega for mixed precision calling
 
     /* declare multi-threading variables required before any goto */
     LIST(CLUSTER) * nodearry = NULL;
-    const int ncpu = omp_get_max_threads();
-    MAT pcl_int[ncpu];                      // Shell for processed intensities
+    const int ncpu = ws->ncpu;
+    MAT * pcl_int = ws->pcl_int;            // Shell for processed intensities
     QSPIKEPTR qspike[ncpu];
     for (int i = 0; i < ncpu; i++) {
-        pcl_int[i] = NULL;
         qspike[i] = NULL;
     }
     int zero_lam[ncpu];
@@ -938,53 +1779,69 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
     }
 #endif
 
-    /* calculate partial covariance */
-    V_part = calculate_covariance(ayb,false);
+    /* model parameters are held fixed if calling only */
+    if (!ayb->callonly) {
+        /* calculate partial covariance */
+        V_part = calculate_covariance(ayb,false);
 
-    if (V_part == NULL) {
-        /* set calls to null and terminate processing */
-        ret_count = DATA_ERR;
-        goto cleanup;
-    }
+        if (V_part == NULL) {
+            /* set calls to null and terminate processing */
+            ret_count = DATA_ERR;
+            goto cleanup;
+        }
 
 #ifndef NDEBUG
-    if (showdebug) {
-        fpout = open_output("covpart");
-        if (!xfisnull(fpout)) {
-            xfputs("covariance parital:\n", fpout);
-            show_MAT(fpout, V_part, 0, 0);
+        if (showdebug) {
+            fpout = open_output("covpart");
+            if (!xfisnull(fpout)) {
+                xfputs("covariance parital:\n", fpout);
+                show_MAT(fpout, V_part, 0, 0);
+            }
+            fpout = xfclose(fpout);
         }
-        fpout = xfclose(fpout);
-    }
 #endif
 
-    /* scale is variance of residuals; get from V full matrix */
-    for (uint_fast32_t cy = 0; cy < ncycle; cy++){
-        ayb->cycle_var->x[cy] = 0.;
-        for (uint_fast32_t b = 0; b < NBASE; b++){
-            uint_fast32_t offset = cy * NBASE + b;
-            ayb->cycle_var->x[cy] += V_part->x[offset * ncycle * NBASE + offset];
+        /* scale is variance of residuals; get from V full matrix */
+        for (uint_fast32_t cy = 0; cy < ncycle; cy++){
+            ayb->cycle_var->x[cy] = 0.;
+            for (uint_fast32_t b = 0; b < NBASE; b++){
+                uint_fast32_t offset = cy * NBASE + b;
+                ayb->cycle_var->x[cy] += V_part->x[offset * ncycle * NBASE + offset];
+            }
+        }
+
+        /* calculate restricted fitted V inverse */
+        ayb->omega = fit_omega(V_part, ayb->omega);
+        if (ayb->omega == NULL) {
+            /* set calls to null and terminate processing */
+            ret_count = DATA_ERR;
+            goto cleanup;
         }
+        
+#ifndef NDEBUG
+        if (showdebug) {
+            fpout = open_output("omfit");
+            if (!xfisnull(fpout)) {
+                xfputs("omega fitted:\n", fpout);
+                show_MAT(fpout, ayb->omega, 0, 0);
+            }
+            fpout = xfclose(fpout);
+        }
+#endif    	
     }
 
-    /* calculate restricted fitted V inverse */
-	ayb->omega = fit_omega(V_part, ayb->omega);
-    if (ayb->omega == NULL) {
+    /* base calling kernels use a compact copy of the omega band, single precision if mixed */
+    if (Precision == E_PREC_MIXED) {
+        omband = new_omega_band(ayb->omega);
+    }
+    else {
+        omtab = new_omega_table(ayb->omega);
+    }
+    if ((omband == NULL) && (omtab == NULL)) {
         /* set calls to null and terminate processing */
         ret_count = DATA_ERR;
         goto cleanup;
     }
-	
-#ifndef NDEBUG
-    if (showdebug) {
-        fpout = open_output("omfit");
-        if (!xfisnull(fpout)) {
-            xfputs("omega fitted:\n", fpout);
-            show_MAT(fpout, ayb->omega, 0, 0);
-        }
-        fpout = xfclose(fpout);
-    }
-#endif    	
 
 #ifndef NDEBUG
     if (showdebug) {
@@ -1019,7 +1876,7 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
     
     /* make an array of list pointers for multi-threading */
     nodearry = array_from_LIST(CLUSTER)(ayb->tile->clusterlist, &ncluster);
-    if (NULL == nodearry) { 
+    if ((NULL == nodearry) || (NULL == A)) { 
         /* set calls to null and terminate processing */
         ret_count = DATA_ERR;
         goto cleanup; 
@@ -1036,8 +1893,8 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
         if (!lastiter && !allowed[cl]) { continue; }
         th_id = omp_get_thread_num();
 
-        cl_bases = ayb->bases.elt + cl * ncycle;
-        cl_quals = ayb->quals.elt + cl * ncycle;
+        cl_bases = ayb->bases.elt + (size_t)cl * ncycle;
+        cl_quals = ayb->quals.elt + (size_t)cl * ncycle;
         pcl_int[th_id] = processNew(AtLU, ayb->N, nodearry[cl]->elt->signals, pcl_int[th_id]);
         if (NULL == pcl_int[th_id]) {
             ret_count = DATA_ERR;
@@ -1046,7 +1903,7 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
 
             /* estimate lambda using Weighted Least Squares */
 //            ayb->lambda->x[cl] = estimate_lambdaWLS(pcl_int, cl_bases, ayb->lambda->x[cl], ayb->cycle_var->x);
-            ayb->lambda->x[cl] = estimate_lambda_A (nodearry[cl]->elt->signals, ayb->N, ayb->At, cl_bases);
+            ayb->lambda->x[cl] = estimate_lambda_cols (nodearry[cl]->elt->signals, ayb->N, A, cl_bases);
             if (ayb->lambda->x[cl] == 0.0) {
                 zero_lam[th_id]++;
             }
@@ -1065,24 +1922,34 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
 
             /* call bases for all cycles */
             NUC sp_bases[ncycle];                   // thread private storage for copy of spike-in sequence
+            real_t qual[ncycle];                    // thread private storage for (real_t) quality values
 
             /* only calculate lss for spike-in data clusters unless last iteration */
             if (!lastiter && ayb->spiked[cl]) {
-                ayb->lss->x[cl] = calculate_lss(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, cl_bases);
+                ayb->lss->x[cl] = (omband == NULL) ?
+                        calculate_lss(pcl_int[th_id], ayb->lambda->x[cl], omtab, cl_bases) :
+                        calculate_lss_mixed(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, omband, cl_bases);
             }
             else {
                 if (ayb->spiked[cl]) {
                     /* save spiked-in sequence for diff counts */ 
                     memcpy(sp_bases, cl_bases, ncycle * sizeof(NUC));
                 }
-                ayb->lss->x[cl] = call_bases(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, cl_bases);
+                if (lastiter) {
+                    /* bases and qualities together, sharing one set of costs */
+                    ayb->lss->x[cl] = (omband == NULL) ?
+                            call_bases_qualities(pcl_int[th_id], ayb->lambda->x[cl], omtab, effDF, cl_bases, qual) :
+                            call_bases_qualities_mixed(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, omband, effDF, cl_bases, qual);
+                }
+                else {
+                    ayb->lss->x[cl] = (omband == NULL) ?
+                            call_bases(pcl_int[th_id], ayb->lambda->x[cl], omtab, cl_bases) :
+                            call_bases_mixed(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, omband, cl_bases);
+                }
             }
             
-            /* call qualities, only needed on last iteration */
+            /* calibrate qualities, only called on last iteration */
             if (lastiter) {
-                real_t qual[ncycle];                // thread private storage for (real_t) quality values
-                call_qualities_post(pcl_int[th_id], ayb->lambda->x[cl], ayb->omega, effDF, cl_bases, qual);
-
                 if (SpikeIn) {
                     if (ayb->spiked[cl]) {
                         /* add obs/diffs to counts */
@@ -1111,7 +1978,7 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
             /* don't do if last iteration for working values */
             if (!lastiter) {
 //                ayb->lambda->x[cl] = estimate_lambdaWLS(pcl_int, cl_bases, ayb->lambda->x[cl], ayb->cycle_var->x);
-                ayb->lambda->x[cl] = estimate_lambda_A (nodearry[cl]->elt->signals, ayb->N, ayb->At, cl_bases);
+                ayb->lambda->x[cl] = estimate_lambda_cols (nodearry[cl]->elt->signals, ayb->N, A, cl_bases);
 
                 /* store the least squares error */
                 store_cluster_error(ayb, pcl_int[th_id], cl);
@@ -1135,12 +2002,17 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
     }
 
     /* calibrate using spike-in data */
-    if (lastiter && SpikeFound) {
+    if (lastiter && ayb->spikefound) {
         calibrate_by_spikein(ayb, blk, qspikesum);
     }
 
+    /* keep converged parameters for the next tile */
+    if (lastiter && (WarmStart != E_WARM_NULL) && !ayb->callonly && !Provisional && (ret_count != DATA_ERR)) {
+        store_warm_start(ayb, blk);
+    }
+
     /* output working values if requested and final iteration */
-    if (lastiter){
+    if (lastiter && !Provisional){
         switch(ShowWorking){
             /* switch cases fall through because working value levels are cumulative */
             case E_SHOWWORK_PROCESSED:
@@ -1161,7 +2033,7 @@ int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showd
                 output_final_values(ayb, effDF, blk);
 
             case E_SHOWWORK_MATRIX:
-                output_final_matrices(ayb, blk);
+                output_final_matrices(ayb, effDF, blk);
 
             case E_SHOWWORK_NULL:
                 break;
@@ -1186,16 +2058,54 @@ cleanup:
 
     free_array_LIST(CLUSTER)(nodearry);
     for (int i = 0; i < ncpu; i++) {
-        free_MAT(pcl_int[i]);
         xfree(qspike[i]);
     }
     free_MAT(AtLU.mat);
     xfree(AtLU.piv);
+    free_MAT(A);
+    xfree(omtab);
+    xfree(omband);
     free_MAT(V_part);
     xfree(qspikesum);
     return ret_count;
 }
 
+/**
+ * Solve the parameter estimation equations, the result replacing rhs.
+ * By conjugate gradient if selected, warm started from the current At and N,
+ * falling back to Cholesky if it does not converge; lhs is then destructively updated.
+ */
+static void solve_parameters(AYB ayb, MAT lhs, MAT rhs) {
+
+    if (Solver == E_SOLVER_PCG) {
+        /* current parameters in the layout of the solution */
+        if (NULL == ayb->ws->x0) {
+            ayb->ws->x0 = new_MAT(rhs->nrow, rhs->ncol);
+        }
+        MAT x0 = ayb->ws->x0;
+        if (NULL != x0) {
+            const uint_fast32_t nrow = ayb->At->nrow;
+            for (uint_fast32_t i = 0; i < rhs->ncol; i++) {
+                for (uint_fast32_t j = 0; j < nrow; j++) {
+                    x0->x[i * rhs->nrow + j] = ayb->At->x[i * nrow + j];
+                }
+                x0->x[i * rhs->nrow + nrow] = ayb->N->x[i];
+            }
+        }
+        const int niter = solverPCG(lhs, rhs, x0, DELTA_DIAG, PCG_TOL, PCG_MAXITER);
+
+        ayb->nsolve++;
+        if (niter >= 0) {
+            ayb->nsolveiter += niter;
+            message(E_SOLVER_ITER_D, MSG_DEBUG, niter);
+            return;
+        }
+        ayb->nfallback++;
+        message(E_SOLVER_FALLBACK_D, MSG_DEBUG, PCG_MAXITER);
+    }
+    solverChol(lhs, rhs, NULL, DELTA_DIAG);
+}
+
 /**
  * Code for parameter estimation loop.
  * Equivalent to parameter_estimation_loop in old AYB.
@@ -1216,27 +2126,28 @@ real_t estimate_MPN(AYB ayb){
         return ret;
     }
 
+    /* terms are calculated into matrices kept in the workspace */
+    WORKSPACE ws = get_workspace(ayb);
     MAT J = NULL, K = NULL;
     MAT Sbar = NULL, Ibar = NULL;
     MAT lhs = NULL, rhs = NULL;
-    real_t * tmp = NULL;
     real_t lambdaf = 1.0;
 
-    if (!FixedParam) {
+    if (NULL == ws) {goto cleanup;}
+    if (!FixedParam && !ayb->callonly) {
         /*  Precalculate terms for iteration */
         //timestamp("Calculating matrices\n",stderr);
         //timestamp("J\t",stderr);
-        J = calculateNewJ(ayb->lambda,ayb->bases,ayb->we,ncycle,ayb->notthinned,NULL);
+        J = calculateNewJ(ayb->lambda,ayb->bases,ayb->we,ncycle,ayb->notthinned,ws->part,ws->J);
         //timestamp("K\t",stderr);
-        K = calculateNewK(ayb->lambda,ayb->bases,ayb->tile,ayb->we,ncycle,ayb->notthinned,NULL);
+        K = calculateNewK(ayb->lambda,ayb->bases,ayb->tile,ayb->we,ncycle,ayb->notthinned,ws->part,ws->K);
         //timestamp("Others\n",stderr);
-        Sbar = calculateSbar(ayb->lambda,ayb->we,ayb->bases,ncycle,ayb->notthinned,NULL);
-        Ibar = calculateIbar(ayb->tile,ayb->we,ayb->notthinned,NULL);
+        Sbar = calculateSbar(ayb->lambda,ayb->we,ayb->bases,ncycle,ayb->notthinned,ws->Sbar);
+        Ibar = calculateIbar(ayb->tile,ayb->we,ayb->notthinned,ws->Ibar);
         real_t Wbar = calculateWbar(ayb->we,ayb->notthinned);
-        tmp = calloc(ncycle*ncycle*NBASE*NBASE,sizeof(real_t));
     
-        lhs = calculateLhs(Wbar, J, Sbar, NULL);
-        rhs = calculateRhs(K, Ibar, NULL);
+        lhs = calculateLhs(Wbar, J, Sbar, ws->lhs);
+        rhs = calculateRhs(K, Ibar, ws->rhs);
 
         if ((NULL==J) || (NULL==K) || (NULL==Sbar) || (NULL==Ibar) || (NULL==lhs) || (NULL==rhs)) { goto cleanup; }
         /* assume ayb->At and Initial_At same size so only need to check one */
@@ -1258,7 +2169,7 @@ real_t estimate_MPN(AYB ayb){
             }
         }
 
-        solverChol(lhs,rhs,NULL,DELTA_DIAG);
+        solve_parameters(ayb, lhs, rhs);
 
         /* extract new At and N */
         nrow = ayb->At->nrow;
@@ -1286,13 +2197,14 @@ real_t estimate_MPN(AYB ayb){
 
 /* cleanup for success and error states */
 cleanup:
-    free_MAT(lhs);
-    free_MAT(rhs);
-    xfree(tmp);
-    free_MAT(Ibar);
-    free_MAT(Sbar);
-    free_MAT(K);
-    free_MAT(J);
+    if (NULL != ws) {
+        keep_MAT(&ws->lhs, lhs);
+        keep_MAT(&ws->rhs, rhs);
+        keep_MAT(&ws->Ibar, Ibar);
+        keep_MAT(&ws->Sbar, Sbar);
+        keep_MAT(&ws->K, K);
+        keep_MAT(&ws->J, J);
+    }
 
     //xfprintf(xstderr,"Initial %e\tImprovement %e\t = %e\n",sumLSS,delta,sumLSS-delta);
     //xfprintf(xstderr,"Updated weights %e\n", update_cluster_weights(ayb));
@@ -1309,7 +2221,7 @@ cleanup:
 bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
 
     validate(NULL != ayb, false);
-    unsigned int ncluster = ayb->ncluster;  // need unsigned int for array_from_LIST
+    size_t ncluster = ayb->ncluster;        // need size_t for array_from_LIST
 
     /* initial M, N, A */
     MAT M = new_MAT(NBASE, NBASE);
@@ -1332,9 +2244,8 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
         return false;
     }
 
-    /* store A as transpose and for first iteration */
+    /* store A as transpose */
     transpose_inplace(ayb->Initial_At);
-    copyinto_MAT(ayb->At, ayb->Initial_At);
 
     /* Initialise call bases return values to nbase * ncycle */
     set_MAT(ayb->lss, NBASE * ayb->ncycle);
@@ -1343,18 +2254,34 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
     set_MAT(ayb->we, 1.0);
     set_MAT(ayb->cycle_var, 1.0);
 
-    /* read in and store any spike-in data */
-    read_spikein_data(ayb, blk);
+    /* replace with values estimated for the lane, else converged values from previous tiles if requested */
+    ayb->callonly = false;
+    /* parameters from a bundle are used for every tile */
+    if (!LaneFitting && !Provisional && !bundle_start(ayb, blk) && !lane_start(ayb, blk)
+        && (WarmStart != E_WARM_NULL)) {
+        warm_start(ayb, blk);
+    }
 
-    /* If thinning, set allowed bases so spikein is never thinned */
-    if (ThinFact > 1) {
+    /* initial A for first iteration */
+    copyinto_MAT(ayb->At, ayb->Initial_At);
+
+    /* read in and store any spike-in data; cluster numbers do not apply to a lane sample */
+    /* and cycles do not match provisional calls */
+    ayb->spikefound = false;
+    if (!LaneFitting && !Provisional) {
+        read_spikein_data(ayb, blk);
+    }
+
+    /* If thinning by factor, set allowed bases so spikein is never thinned; all clusters called if calling only */
+    if ((ThinFact > 1) && (ThinTarget == 0) && !ayb->callonly) {
         memcpy(ayb->notthinned, ayb->spiked, ayb->ncluster * sizeof(bool));
-        for (int i = 0; i < ayb->ncluster; i += ThinFact) {
+        for (uint_fast32_t i = 0; i < ayb->ncluster; i += ThinFact) {
             ayb->notthinned[i] = true;
         }
     }
 
     struct structLU AtLU = LUdecomposition(ayb->At);
+    MAT A = transpose(ayb->At);             // column table for lambda estimation
     bool ret = true;
 
 #ifndef NDEBUG
@@ -1372,15 +2299,12 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
     NUC * cl_bases = NULL;
     PHREDCHAR * cl_quals = NULL;
     int th_id;                              // thread number
-    const int ncpu = omp_get_max_threads();
-    MAT pcl_int[ncpu];                      // Shell for processed intensities
-    for (int i = 0; i < ncpu; i++) {
-        pcl_int[i] = NULL;
-    }
+    WORKSPACE ws = get_workspace(ayb);
+    MAT * pcl_int = (NULL == ws) ? NULL : ws->pcl_int;  // Shell for processed intensities
     
     /* make an array of list pointers for multi-threading */
     nodearry = array_from_LIST(CLUSTER)(ayb->tile->clusterlist, &ncluster);
-    if (NULL==nodearry) { 
+    if ((NULL==nodearry) || (NULL==A) || (NULL==pcl_int)) { 
         ret = false;
         goto cleanup; 
     }
@@ -1396,8 +2320,8 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
         if (!ayb->notthinned[cl]) { continue; }
         th_id = omp_get_thread_num();
 
-        cl_bases = ayb->bases.elt + cl * ayb->ncycle;
-        cl_quals = ayb->quals.elt + cl * ayb->ncycle;
+        cl_bases = ayb->bases.elt + (size_t)cl * ayb->ncycle;
+        cl_quals = ayb->quals.elt + (size_t)cl * ayb->ncycle;
         pcl_int[th_id] = processNew(AtLU, ayb->N, nodearry[cl]->elt->signals, pcl_int[th_id]);
         if (NULL == pcl_int[th_id]) {
             ret = false;
@@ -1429,23 +2353,32 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
             }
             /* initial lambda */
 //            ayb->lambda->x[cl] = estimate_lambdaOLS(pcl_int, cl_bases);
-            ayb->lambda->x[cl] = estimate_lambda_A (nodearry[cl]->elt->signals, ayb->N, ayb->At, cl_bases);
+            ayb->lambda->x[cl] = estimate_lambda_cols (nodearry[cl]->elt->signals, ayb->N, A, cl_bases);
 
             /* store the least squares error */
             store_cluster_error(ayb, pcl_int[th_id], cl);
-            if (count >= ZeroThin) {
+            if ((count >= ZeroThin) && !ayb->callonly) {
                 /* set to thin */
                 ayb->notthinned[cl] = false;
             }
         }
     }
     
+    /* thin to target using initial lambda */
+    if ((ThinTarget > 0) && !ayb->callonly) {
+        if (!thin_to_target(ayb)) {
+            message(E_NOMEM_S, MSG_ERR, "thinning to target; all clusters used");
+        }
+    }
+
     /* output how many clusters for parameter estimation */
-    count = 0;
-    for (cl = 0; cl < ncluster; cl++){
-        if (ayb->notthinned[cl]) { count++; }
+    if (!ayb->callonly) {
+        count = 0;
+        for (cl = 0; cl < ncluster; cl++){
+            if (ayb->notthinned[cl]) { count++; }
+        }
+        message(E_THIN_DDF, MSG_INFO, count, ayb->ncluster, (float)count * 100/ayb->ncluster);
     }
-    message(E_THIN_DDF, MSG_INFO, count, ayb->ncluster, (float)count * 100/ayb->ncluster);
 
 #ifndef NDEBUG
     if (showdebug) {
@@ -1456,14 +2389,59 @@ bool initialise_model(AYB ayb, const int blk, const bool showdebug) {
 /* cleanup for success and error states */
 cleanup:
     free_array_LIST(CLUSTER)(nodearry);
-    for (int i = 0; i < ncpu; i++) {
-        free_MAT(pcl_int[i]);
-    }
     free_MAT(AtLU.mat);
     xfree(AtLU.piv);
+    free_MAT(A);
     return ret;
 }
 
+/**
+ * Store the model parameters of a data block as the estimate for its whole lane.
+ * Call after parameter estimation iterations on a lane sample, before any final calling iteration.
+ * Returns false if storage fails.
+ */
+bool store_lane_param(const AYB ayb, const int blk) {
+
+    validate(NULL != ayb, false);
+    struct ParamT * newparam = realloc(LaneParam, (NLaneParam + 1) * sizeof(*LaneParam));
+    if (NULL == newparam) {return false;}
+    LaneParam = newparam;
+
+    struct ParamT * param = LaneParam + NLaneParam;
+    memset(param, 0, sizeof(*param));
+    if (!copy_param(param, ayb)) {return false;}
+    param->blk = warm_index(blk);
+    /* median as would be used by a final iteration */
+    param->effdf = median(ayb->lss->x, ayb->notthinned, ayb->ncluster);
+    NLaneParam++;
+    return true;
+}
+
+/** Free all stored lane parameters. */
+void clear_lane_param(void) {
+
+    for (unsigned int i = 0; i < NLaneParam; i++) {
+        clear_param(LaneParam + i);
+    }
+    xfree(LaneParam);
+    LaneParam = NULL;
+    NLaneParam = 0;
+}
+
+/** Set whether models are being fitted to a lane sample rather than a tile. */
+void set_lane_fitting(const bool fitting) {
+    LaneFitting = fitting;
+}
+
+/**
+ * Set whether models are calling the first cycles of an incomplete tile.
+ * Provisional models start from the initial values, do not use spike-in data
+ * and are not kept for warm start or output as working values.
+ */
+void set_provisional(const bool provisional) {
+    Provisional = provisional;
+}
+
 /** Parse a string for an expected unsigned int. Returns zero if not found. */
 unsigned int parse_uint(const CSTRING str) {
 
@@ -1493,6 +2471,57 @@ bool set_show_working(const CSTRING shwkstr) {
     }
 }
 
+/**
+ * Set warm start mode. Text must match one of the WarmStart text list. Ignores case.
+ * Returns true if match found.
+ */
+bool set_warm_start(const CSTRING warm_str) {
+
+    /* match to one of the possible options */
+    int matchidx = match_string(warm_str, WARMSTART_TEXT, E_WARM_NUM);
+    if (matchidx >= 0) {
+        WarmStart = (WARMSTART)matchidx;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * Set base calling precision. Text must match one of the Precision text list. Ignores case.
+ * Returns true if match found.
+ */
+bool set_precision(const CSTRING prec_str) {
+
+    /* match to one of the possible options */
+    int matchidx = match_string(prec_str, PRECISION_TEXT, E_PREC_NUM);
+    if (matchidx >= 0) {
+        Precision = (PRECISION)matchidx;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * Set solver of the parameter estimation equations. Text must match one of the Solver text list. Ignores case.
+ * Returns true if match found.
+ */
+bool set_solver(const CSTRING solver_str) {
+
+    /* match to one of the possible options */
+    int matchidx = match_string(solver_str, SOLVER_TEXT, E_SOLVER_NUM);
+    if (matchidx >= 0) {
+        Solver = (SOLVER)matchidx;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
 /** Set factor with which to thin out clusters. */
 bool set_thin_factor(const CSTRING thinfac_str) {
 
@@ -1500,6 +2529,35 @@ bool set_thin_factor(const CSTRING thinfac_str) {
     return (ThinFact > 0);
 }
 
+/** Set the target number of clusters for parameter estimation. */
+bool set_thin_target(const CSTRING n_str) {
+
+    ThinTarget = parse_uint(n_str);
+    return (ThinTarget > 0);
+}
+
+/** Set the random seed for thinning to target. */
+bool set_thin_seed(const CSTRING seed_str) {
+
+    char *endptr;
+    long n = strtol(seed_str, &endptr, 0);
+    if ((endptr == seed_str) || (*endptr != '\0') || (n < 0) || (n > UINT32_MAX)) {return false;}
+    ThinSeed = n;
+    return true;
+}
+
+/** Return true if parameter bundles are supplied. */
+bool param_bundle(void) {
+    return (BundleList != NULL);
+}
+
+/** Set the parameter bundle file paths, separated by commas; one per data block. */
+void set_param_bundle(const CSTRING bundle_str) {
+
+    free_CSTRING(BundleList);
+    BundleList = copy_CSTRING(bundle_str);
+}
+
 /** Set spike-in data calibration flag. */
 void set_spike_calib(void) {
 
@@ -1520,8 +2578,22 @@ bool set_zerothin_limit(const CSTRING n_str) {
  */
 bool startup_ayb(void) {
 
-    message(E_OPT_SELECT_SG, MSG_INFO, "Thin factor", (float)ThinFact);
+    if (ThinTarget > 0) {
+        message(E_THINTARGET_DD, MSG_INFO, ThinTarget, ThinSeed);
+    }
+    else {
+        message(E_OPT_SELECT_SG, MSG_INFO, "Thin factor", (float)ThinFact);
+    }
     message(E_ZEROTHIN_D, MSG_INFO, ZeroThin);
+    if (WarmStart != E_WARM_NULL) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Warm start", WARMSTART_TEXT[WarmStart]);
+    }
+    if (Precision != E_PREC_DOUBLE) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Calling precision", PRECISION_TEXT[Precision]);
+    }
+    if (Solver != E_SOLVER_CHOL) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Parameter solver", SOLVER_TEXT[Solver]);
+    }
 
     /* check if spike-in data configured */
     SpikeIn = spike_in();
@@ -1563,10 +2635,26 @@ bool startup_ayb(void) {
         }
     }
 
+    /* read any parameter bundles; these replace fixed matrices for the blocks they cover */
+    if (BundleList != NULL) {
+        if (!read_bundles()) {
+            return false;
+        }
+        message(E_OPT_SELECT_SS, MSG_INFO, "Fixed parameters", "call only from parameter bundle");
+    }
+
     /* read any quality calibration table */
     return read_quality_table();
 }
 
+/** Clear any stored warm start parameters so the next tile starts from the initial values. */
+void clear_warm_start(void) {
+
+    for (unsigned int i = 0; i < NWarm; i++) {
+        clear_param(Warm + i);
+    }
+}
+
 /** Tidy up; call at program shutdown. */
 void tidyup_ayb(void) {
 
@@ -1574,4 +2662,16 @@ void tidyup_ayb(void) {
     for (IOTYPE idx = (IOTYPE)0; idx < E_MNP; idx++) {
         Matrix[idx] = free_MAT(Matrix[idx]);
     }
+    clear_warm_start();
+    xfree(Warm);
+    Warm = NULL;
+    NWarm = 0;
+    clear_lane_param();
+    for (unsigned int i = 0; i < NBundle; i++) {
+        clear_param(Bundle + i);
+    }
+    xfree(Bundle);
+    Bundle = NULL;
+    NBundle = 0;
+    BundleList = free_CSTRING(BundleList);
 }
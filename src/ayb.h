@@ -50,24 +50,41 @@ AYB new_AYB(const uint_fast32_t ncycle, const uint_fast32_t ncluster);
 AYB free_AYB(AYB ayb);
 AYB copy_AYB(const AYB ayb);
 void show_AYB(XFILE * fp, const AYB ayb, bool showall);
+bool write_AYB_state(XFILE * fp, const AYB ayb);
+bool read_AYB_state(XFILE * fp, AYB ayb);
 
 /* access functions */
 real_t * get_AYB_lambdas(AYB ayb, uint_fast32_t *num);
 uint_fast32_t get_AYB_ncluster(AYB ayb);
+bool get_AYB_callonly(AYB ayb);
 uint_fast32_t get_AYB_ncycle(AYB ayb);
 TILE get_AYB_tile(AYB ayb);
 AYB replace_AYB_tile(AYB ayb, const TILE tile);
 void show_AYB_bases(XFILE * fp, const AYB ayb, const uint_fast32_t cl);
 void show_AYB_quals(XFILE * fp, const AYB ayb, const uint_fast32_t cl);
+void get_AYB_calls(const AYB ayb, char * bases, char * quals);
+void report_AYB_solver(AYB ayb);
 
 MAT calculate_covariance(AYB ayb, const bool do_full);
 int estimate_bases(AYB ayb, const int blk, const bool lastiter, const bool showdebug);
 real_t estimate_MPN(AYB ayb);
 bool initialise_model(AYB ayb, const int blk, const bool showdebug);
+bool store_lane_param(const AYB ayb, const int blk);
+void clear_lane_param(void);
+void clear_warm_start(void);
+void set_lane_fitting(const bool fitting);
+bool param_bundle(void);
+void set_provisional(const bool provisional);
 
 unsigned int parse_uint(const CSTRING str);
+void set_param_bundle(const CSTRING bundle_str);
+bool set_precision(const CSTRING prec_str);
 bool set_show_working(const CSTRING shwkstr);
+bool set_solver(const CSTRING solver_str);
 bool set_thin_factor(const CSTRING thinfac_str);
+bool set_thin_seed(const CSTRING seed_str);
+bool set_thin_target(const CSTRING n_str);
+bool set_warm_start(const CSTRING warm_str);
 void set_spike_calib(void);
 bool set_zerothin_limit(const CSTRING n_str);
 bool startup_ayb(void);
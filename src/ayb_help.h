@@ -24,6 +24,8 @@
 "  -k  --spikeuse\t\tUse spike-in data to calibrate qualities\n"
 "\t\t\t\t(Alternative to output of quality counts file)\n"
 "  -i  --input <path>\t\tLocation of input files [default: \"\"]\n"
+"  -j  --concurrent\t\tModel the data blocks of a tile concurrently\n"
+"\t\t\t\t(Threads are shared between blocks)\n"
 "  -l  --loglevel <level>\tLevel of message output [default: warning]\n"
 "\t\t\t\t(none/fatal/error/information/warning/debug)\n"
 "  -n  --niter <num>\t\tNumber of model iterations [default: 5]\n"
@@ -35,18 +37,41 @@
 "  -s  --simdata <header>\tOutput simulation data\n"
 "  -t  --thin <factor>\t\tThin number of clusters by factor [default: 1]\n"
 "\t\t\t\t(Used in parameter estimation)\n"
+"  -u  --spool <path>\t\tProcess jobs placed in spool directory until stopped\n"
+"\t\t\t\t(Prefix not required)\n"
 "  -w  --working <level>\t\tOutput final working values to level\n"
 "\t\t\t\t(none/matrices/values/processed) [default: none]\n"
+"  -x  --workers <num>\t\tAnalyse the tiles of each prefix in num processes\n"
+"\t\t\t\t(Threads are shared between workers) [default: 1]\n"
 "  -z  --zerothin <num>\t\tThin clusters with too many zero data cycles\n"
 "\t\t\t\t(Those with num or more) [default 3]\n"
 "  -A  --A <filepath>\t\tPredetermined fixed Parameter A matrix file path\n"
 "\t\t\t\t(Must be accompanied by option N)\n"
+"  -B  --bundle <filepath[,...]>\tParameter bundle file per data block; call each\n"
+"\t\t\t\ttile once with the bundle parameters held fixed\n"
+"  -C  --nocheckpoint\t\tDo not checkpoint the model state after each iteration\n"
+"  -E  --solver <mode>\t\tParameter estimation solver (cholesky/pcg)\n"
+"\t\t\t\t[default: cholesky]\n"
 "  -K  --spikein <path>\t\tLocation of spike-in data files\n"
+"  -L  --lanefit <num>\t\tEstimate parameters per lane from num clusters\n"
+"\t\t\t\tsampled from each tile, then call each tile once\n"
 "  -M  --M <filepath>\t\tPredetermined initial Crosstalk matrix file path\n"
 "  -N  --N <filepath>\t\tPredetermined fixed Noise matrix file path\n"
 "\t\t\t\t(Must be accompanied by option A)\n"
+"  -P  --precision <mode>\tBase calling precision (double/mixed)\n"
+"\t\t\t\t[default: double]\n"
 "  -Q  --qualtab <filepath>\tQuality calibration table\n"
+"  -R  --realtime <num>\t\tCall run-folder tiles as their cycles are written\n"
+"\t\t\t\t(Provisional calls of first num cycles)\n"
 "  -S, --samplename <name>\tSample name for output\n"
+"  -T  --thintarget <num>\tThin to num clusters stratified by brightness\n"
+"\t\t\t\tand position (Replaces thin factor)\n"
+"  -W  --warmstart <mode>\tStart each tile from parameters of previous tiles\n"
+"\t\t\t\t(none/previous/average) [default: none]\n"
+"  -X  --clusterrange <first:last>\tCall only clusters first to last of each tile\n"
+"\t\t\t\t(Needs option B; merge with AYB_merge_shards.sh)\n"
+"  -Y  --thinseed <num>\t\tRandom seed for thinning to target [default: 1]\n"
+"  -Z  --resume\t\t\tSkip completed tiles and continue from checkpoints\n"
 "\n"
 "  --help\t\t\tDisplay this help\n"
 "  --licence\t\t\tDisplay AYB licence information\n"
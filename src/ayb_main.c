@@ -3,6 +3,7 @@
  * Main AYB module.
  * Sets up environment before looping through each supplied pattern,
  * passing control to ayb_model for each intensity file found.
+ * In service mode then processes the patterns of each job in a spool directory until asked to stop.
  * Tidy up to finish.
  *//*
  *  Created : 23 Feb 2010
@@ -34,6 +35,10 @@
 #include <stdbool.h>
 #include <signal.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include "ayb_model.h"
 #include "ayb_options.h"
 #include "datablock.h"
@@ -45,10 +50,20 @@
 
 
 /* constants */
-/* none    */
+
+static const unsigned int JOB_WAIT = 2;         ///< Seconds between checks of an empty spool directory.
+
+/** Job result text. Match to RETOPT enum. */
+static const char *JOB_RESULT_TEXT[] = {"completed", "failed", "stopped"};
 
 /* members */
-/* none    */
+
+static int NWorker = 1;                         ///< Number of worker processes analysing tiles.
+static int WorkerThread = 1;                    ///< Number of threads in each worker process.
+static bool WorkerFail = false;                 ///< Set if any worker process ended abnormally.
+static long *Queue = NULL;                      ///< Shared count of items claimed by worker processes.
+static long Item = 0;                           ///< Index of the next item of the pattern in this process.
+static long Claimed = -1;                       ///< Index of the item last claimed by this process.
 
 
 /* private functions */
@@ -62,6 +77,241 @@ static void tidyup(void) {
     tidyup_qual_table();
 }
 
+/**
+ * Return true if this process should analyse the next item of the current pattern.
+ * Each worker process steps through the same sequence of items and takes the next
+ * unclaimed one from the shared queue when it is ready, so work is shared dynamically.
+ * Always true if there are no workers.
+ */
+static bool claim_item(void) {
+
+    if (Queue == NULL) {return true;}
+    if (Claimed < Item) {
+        Claimed = __atomic_fetch_add(Queue, 1, __ATOMIC_SEQ_CST);
+    }
+    return (Item++ == Claimed);
+}
+
+/**
+ * Process each intensity file or run-folder lane/tile of the current pattern until no more or a no continue error.
+ * If sample is set then each tile is sampled for lane estimation instead of analysed.
+ * Returns the status of the last tile, continue if there were none or all were analysed.
+ */
+static RETOPT process_pattern(const int argc, char ** const argv, const bool sample, XFILE **fp) {
+
+    const CSTRING input_path = get_input_path();
+    const unsigned int totalcycle = get_totalcycle();
+    LANETILE lanetile = {0, 0};
+    RETOPT status = E_CONTINUE;
+
+    while (status == E_CONTINUE) {
+
+        if (run_folder()) {
+            /* get lane/tile numbers */
+            lanetile = get_next_lanetile();
+            if (lanetile_isnull(lanetile)) {
+                /* next prefix */
+                break;
+            }
+        }
+        else {
+            /* open the intensities file */
+            *fp = open_next(*fp);
+            lanetile = get_current_lanetile();
+            if (xfisnull(*fp)) {
+                /* next prefix */
+                break;
+            }
+        }
+
+        if (claim_item()) {
+            if (!sample && completed_tile()) {
+                /* already analysed by an interrupted run */
+                continue;
+            }
+            if (run_folder()) {
+                /* read intensities data from run-folder */
+                read_intensities_folder(input_path, lanetile, totalcycle);
+            }
+            else {
+                /* read intensities data from supplied file */
+                read_intensities_file(*fp, lanetile, totalcycle);
+            }
+
+            /* sample or analyse the stored tile */
+            status = sample ? sample_tile() : analyse_tile(argc, argv);
+        }
+    }
+    return status;
+}
+
+/**
+ * Analyse the current pattern with a number of worker processes sharing a queue of its items.
+ * Each worker writes its messages to a temporary file, appended to the message log in worker order
+ * once all have finished. A worker that fails to start or ends abnormally is reported and recorded.
+ * Returns the most severe status of the workers.
+ */
+static RETOPT process_workers(const int argc, char ** const argv, XFILE **fp) {
+
+    RETOPT status = E_FAIL;
+    pid_t *pid = calloc(NWorker, sizeof(*pid));
+    FILE **log = calloc(NWorker, sizeof(*log));
+    Queue = mmap(NULL, sizeof(*Queue), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if ((pid == NULL) || (log == NULL) || (Queue == MAP_FAILED)) {
+        /* run in this process instead */
+        message(E_NOCREATE_S, MSG_ERR, "worker processes");
+        if (Queue == MAP_FAILED) {Queue = NULL;}
+        status = process_pattern(argc, argv, false, fp);
+        goto cleanup;
+    }
+    *Queue = 0;
+    Item = 0;
+    Claimed = -1;
+    status = E_CONTINUE;
+
+    /* do not duplicate buffered output, nor an idle thread pool that would not survive the fork */
+    fflush(stdout);
+    fflush(stderr);
+    omp_pause_resource_all(omp_pause_hard);
+
+    for (int w = 0; w < NWorker; w++) {
+        log[w] = tmpfile();
+        pid[w] = (log[w] == NULL) ? -1 : fork();
+
+        if (pid[w] == 0) {
+            /* worker process; messages to own log, analyse claimed items and exit */
+            dup2(fileno(log[w]), STDERR_FILENO);
+            omp_set_num_threads(WorkerThread);
+            RETOPT wstatus = process_pattern(argc, argv, false, fp);
+            fflush(stdout);
+            fflush(stderr);
+            _exit(wstatus);
+        }
+        if (pid[w] < 0) {
+            message(E_NOCREATE_S, MSG_ERR, "worker process");
+            WorkerFail = true;
+        }
+    }
+
+    for (int w = 0; w < NWorker; w++) {
+        if (pid[w] > 0) {
+            int wstatus = 0;
+            waitpid(pid[w], &wstatus, 0);
+            if (WIFEXITED(wstatus) && (WEXITSTATUS(wstatus) <= E_STOP)) {
+                /* keep the most severe worker status */
+                if (WEXITSTATUS(wstatus) > (int)status) {status = WEXITSTATUS(wstatus);}
+            }
+            else {
+                message(E_WORKER_FAIL_DD, MSG_ERR, w + 1, wstatus);
+                WorkerFail = true;
+            }
+        }
+
+        /* append any worker messages to the log */
+        if (log[w] != NULL) {
+            char buf[BUFSIZ];
+            size_t n;
+            rewind(log[w]);
+            if ((n = fread(buf, 1, sizeof(buf), log[w])) > 0) {
+                message(E_WORKER_LOG_D, MSG_INFO, w + 1);
+                do {
+                    fwrite(buf, 1, n, stderr);
+                } while ((n = fread(buf, 1, sizeof(buf), log[w])) > 0);
+                fflush(stderr);
+            }
+            fclose(log[w]);
+        }
+    }
+
+cleanup:
+    if (Queue != NULL) {
+        munmap(Queue, sizeof(*Queue));
+        Queue = NULL;
+    }
+    xfree(log);
+    xfree(pid);
+    return status;
+}
+
+/**
+ * Process a prefix or lane/tile range argument, after a lane estimation pass if selected.
+ * Returns fail if the argument is not valid or the analysis of a tile failed,
+ * stop if the program should stop, else continue.
+ */
+static RETOPT process_argument(const int argc, char ** const argv, const CSTRING pattern, XFILE **fp) {
+
+    RETOPT status = E_CONTINUE;
+
+    if (lane_estimation()) {
+        /* first pass samples every tile to estimate model parameters per lane */
+        if (set_pattern(pattern)) {
+            status = process_pattern(argc, argv, true, fp);
+            if (status == E_STOP) {return status;}
+        }
+        estimate_lanes();
+    }
+
+    if (!set_pattern(pattern)) {
+        return E_FAIL;
+    }
+    if (NWorker > 1) {
+        status = process_workers(argc, argv, fp);
+    }
+    else {
+        status = process_pattern(argc, argv, false, fp);
+    }
+    return status;
+}
+
+/**
+ * Service mode; process each job placed in the spool directory until a stop file is found.
+ * Each job is a new run; model parameters are not carried between jobs.
+ * The result and elapsed time of each job are written to its status file.
+ * Returns stop if the program should stop, else continue.
+ */
+static RETOPT process_jobs(const int argc, char ** const argv, XFILE **fp) {
+
+    RETOPT status = E_CONTINUE;
+
+    while ((status != E_STOP) && !stop_jobs()) {
+        CSTRING job = claim_job();
+        if (job == NULL) {
+            sleep(JOB_WAIT);
+            continue;
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        message(E_JOB_START_S, MSG_INFO, job);
+        reset_model();
+
+        /* a job fails if it cannot be read or any of its patterns fails */
+        int npattern = 0;
+        CSTRING *pattern = read_job(job, &npattern);
+        RETOPT result = (pattern == NULL) ? E_FAIL : E_CONTINUE;
+        for (int i = 0; i < npattern; i++) {
+            if (status != E_STOP) {
+                status = process_argument(argc, argv, pattern[i], fp);
+                if (status > result) {result = status;}
+            }
+            free_CSTRING(pattern[i]);
+        }
+        xfree(pattern);
+        *fp = xfclose(*fp);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        const double seconds = (end.tv_sec - start.tv_sec) + 1.0E-9 * (end.tv_nsec - start.tv_nsec);
+        finish_job(job, JOB_RESULT_TEXT[result], seconds);
+        message(E_JOB_END_SS, MSG_INFO, job, JOB_RESULT_TEXT[result]);
+        free_CSTRING(job);
+    }
+
+    /* later outputs go to the service locations */
+    set_job_location(NULL, NULL);
+    return status;
+}
+
 /* public functions */
 
 /**
@@ -73,7 +323,6 @@ int main(int argc, char **argv) {
 
     int ret = EXIT_SUCCESS;
     int nextarg = 0;
-    LANETILE lanetile = {0, 0};
     XFILE *fp = NULL;
 
     /* install signal handler - interrupt does not work as written, do not enable */
@@ -95,8 +344,8 @@ int main(int argc, char **argv) {
             break;
 
         case E_CONTINUE:
-            /* check if any non-option pattern match arguments supplied */
-            if (nextarg >= argc) {
+            /* check if any non-option pattern match arguments supplied; optional for a service */
+            if ((nextarg >= argc) && !spool_jobs()) {
                 message(E_NOPATTERN, MSG_ERR);
                 ret = EXIT_FAILURE;
                 goto cleanup;
@@ -132,53 +381,30 @@ int main(int argc, char **argv) {
     omp_set_num_threads(rthread);
     int sthread = omp_get_max_threads();
     message(E_THREAD_DD, MSG_INFO, sthread, rthread);
+    message(E_OPT_SELECT_SS, MSG_INFO, "Kernel code path", kernel_code_path());
 
-    const CSTRING input_path = get_input_path();
-    const unsigned int totalcycle = get_totalcycle();
+    /* share the threads between any worker processes */
+    NWorker = get_nworker();
+    if ((NWorker > 1) && concatenate()) {
+        /* concatenated results must be written by a single process */
+        message(E_BAD_TXT_SS, MSG_WARN, "Workers option", "not used with concatenate");
+        NWorker = 1;
+    }
+    if (NWorker > 1) {
+        WorkerThread = (sthread > NWorker) ? sthread / NWorker : 1;
+        message(E_WORKER_DD, MSG_INFO, NWorker, WorkerThread);
+    }
 
     /* process each prefix or lane/tile range supplied as non-option argument */
     for (int i = nextarg; i < argc; i++) {
-        if (set_pattern(argv[i])) {
-            /* process each intensity file or run-folder lane/tile until no more or a no continue error */
-            status = E_CONTINUE;
-
-            while (status == E_CONTINUE) {
-
-                if (run_folder()) {
-                    /* get lane/tile numbers */
-                    lanetile = get_next_lanetile();
-                    if (lanetile_isnull(lanetile)) {
-                        /* next prefix */
-                        status = E_FAIL;
-                    }
-                }
-                else {
-                    /* open the intensities file */
-                    fp = open_next(fp);
-		    lanetile = get_current_lanetile();
-                    if (xfisnull(fp)) {
-                        /* next prefix */
-                        status = E_FAIL;
-                    }
-                }
-
-                if (status == E_CONTINUE) {
-                    if (run_folder()) {
-                        /* read intensities data from run-folder */
-                        read_intensities_folder(input_path, lanetile, totalcycle);
-                    }
-                    else {
-                        /* read intensities data from supplied file */
-                        read_intensities_file(fp, lanetile, totalcycle);
-                    }
-
-                    /* analyse the stored tile */
-                    status = analyse_tile(argc, argv);
-                }
-            }
-            /* analysis return may indicate stop program */
-            if (status == E_STOP) {break;}
-        }
+        status = process_argument(argc, argv, argv[i], &fp);
+        /* analysis return may indicate stop program */
+        if (status == E_STOP) {break;}
+    }
+
+    /* then any jobs in service mode */
+    if ((status != E_STOP) && spool_jobs()) {
+        status = process_jobs(argc, argv, &fp);
     }
 
     /* output the quality calibration table if not turned off */
@@ -194,7 +420,13 @@ int main(int argc, char **argv) {
     else {
         pname++;
     }
-    fprintf(stderr, "AYB completed successfully\n");
+    if (WorkerFail) {
+        fprintf(stderr, "AYB completed with worker failures\n");
+        ret = EXIT_FAILURE;
+    }
+    else {
+        fprintf(stderr, "AYB completed successfully\n");
+    }
     fprintf(stdout, "End of %s\n", pname);
 
 cleanup:
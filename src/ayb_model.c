@@ -27,9 +27,12 @@
  */
 
 #include <math.h>
+#include <stdio.h>
 #include <string.h>
 #include <err.h>
+#include <unistd.h>
 #include "ayb.h"
+#include "aybthread.h"
 #include "ayb_model.h"
 #include "ayb_options.h"
 #include "ayb_version.h"
@@ -45,6 +48,13 @@
 /* constants */
 
 static const unsigned int MIN_CYCLE = 2;        ///< Minimum cycles for modelling.
+static const unsigned int CYCLE_WAIT = 10;      ///< Seconds between checks for new cycles in real-time mode.
+static const unsigned int CYCLE_TIMEOUT = 7200; ///< Seconds without a new cycle before real-time mode gives up.
+static const char *PROV_TAG = "prov.";          ///< Output file tag prefix for provisional calls.
+static const char *CKPT_TAG = "ckpt";           ///< Output file tag for a data block checkpoint.
+static const char *CKPT_PART = ".part";         ///< Suffix of a checkpoint while it is written.
+static const char CKPT_ID[8] = "AYBckpt2";      ///< Identifier at the start of a checkpoint file.
+static const size_t RANGE_LEN = 24;             ///< Enough for a cluster range tag prefix "c<first>-<last>.".
 
 /** Possible output format text. Match to OUTFORM enum. Used to match program argument and also as file extension. */
 static const char *OUTFORM_TEXT[] = {"fasta", "fasta.gz", "fasta.bz2", "fastq", "fastq.gz", "fastq.bz2"};
@@ -58,10 +68,21 @@ typedef enum OutFormT {E_FASTA, E_FASTAGZ, E_FASTABZ, E_FASTQ, E_FASTQGZ, E_FAST
 static OUTFORM OutputFormat  = E_FASTQ;         ///< Selected output format.
 
 static unsigned int NIter = 5;                  ///< Number of iterations in base call loop.
-static unsigned int *ZeroLambda = NULL;         ///< Count of zero lambdas before base call, per iteration.
+static unsigned int *ZeroLambda = NULL;         ///< Count of zero lambdas before base call, per data block and iteration.
 static bool SimData = false;                    ///< Set to output simulation data.
 static CSTRING SimText = NULL;                  ///< Header text for simulation data file.
 static TILE MainTile = NULL;                    ///< Tile data from file or run-folder.
+static bool UsedOnly = false;                   ///< Tile data holds only the cycles used by the data blocks.
+static unsigned int LaneSample = 0;             ///< Clusters sampled per tile for lane estimation, zero for none.
+static TILE *LaneTile = NULL;                   ///< Sampled clusters of each lane for lane estimation.
+static unsigned int NLaneTile = 0;              ///< Number of lanes sampled.
+static bool Concurrent = false;                 ///< Model the data blocks of a tile concurrently.
+static unsigned int RealTime = 0;               ///< Cycles for provisional calls of a run-folder still being written.
+static bool Checkpoint = true;                  ///< Checkpoint the model state after each iteration.
+static bool Resume = false;                     ///< Skip completed tiles and continue from checkpoints.
+static unsigned int ClusterFirst = 0;           ///< First cluster of each tile to call, counting from one.
+static unsigned int ClusterLast = 0;            ///< Last cluster of each tile to call, zero for all clusters.
+static CSTRING RangeTag = NULL;                 ///< Output file tag with the cluster range, null if none.
 
 /* Additional data size constraint for debug output, set in analyse_tile */
 static bool ShowDebug = false;
@@ -69,15 +90,19 @@ static bool ShowDebug = false;
 
 /* private functions */
 
-/** Create the sub-tile datablocks to be analysed. */
+/**
+ * Create the sub-tile datablocks to be analysed.
+ * Blocks view the intensities of maintile without copying, except where concatenated
+ * cycles do not follow on, so maintile must not be freed before the blocks.
+ */
 static TILE * create_datablocks(const TILE maintile, const unsigned int numblock) {
 
     TILE * tileblock = NULL;
     if (get_defaultblock()) {
-        /* copy all into single block */
+        /* view all as single block */
         tileblock = calloc(1, sizeof(*tileblock));
         if(tileblock == NULL) {return NULL;}
-        tileblock[0] = copy_TILE(maintile);
+        tileblock[0] = view_append_TILE(NULL, maintile, 0, maintile->ncycle - 1);
     }
 
     else {
@@ -102,11 +127,15 @@ static TILE * create_datablocks(const TILE maintile, const unsigned int numblock
 
             /* no break; fall through to case CONCAT */
             case E_CONCAT :
-                tileblock[blk] = copy_append_TILE(tileblock[blk], maintile, colstart, colend);
+                tileblock[blk] = view_append_TILE(tileblock[blk], maintile, colstart, colend);
                 break;
 
             case E_IGNORE :
                 /* just increment column pointers, done outside of switch */
+                if (UsedOnly) {
+                    /* unless ignored cycles were not read */
+                    colend = colstart - 1;
+                }
                 break;
 
             default :;
@@ -120,8 +149,194 @@ static TILE * create_datablocks(const TILE maintile, const unsigned int numblock
     return tileblock;
 }
 
+/**
+ * Check the stored tile has enough cycles for modelling, freeing it if not.
+ * Returns fail if the tile was rejected, else continue.
+ * MainTile is null on return if there is nothing to analyse.
+ */
+static RETOPT check_tile(void) {
+
+    if (MainTile == NULL) {
+        if (!run_folder()) {
+            /* if not a run-folder then problem caused by bad input file */
+            message(E_BAD_INPUT_S, MSG_ERR, get_current_file());
+        }
+        return E_CONTINUE;
+    }
+
+    if (MainTile->ncluster == 0) {
+        /* nothing in the cluster range */
+        message(E_NOCLUSTER_S, MSG_WARN, get_current_file());
+        MainTile = free_TILE(MainTile);
+        return E_CONTINUE;
+    }
+
+    const unsigned int needcycle = UsedOnly ? get_usedcycle() : get_totalcycle();
+    if (MainTile->ncycle < needcycle) {
+        /* not enough data */
+        message(E_CYCLESIZE_DD, MSG_ERR, MainTile->ncycle, needcycle);
+        MainTile = free_TILE(MainTile);
+        return E_FAIL;
+    }
+    else if (MainTile->ncycle < MIN_CYCLE) {
+        message(E_CYCLESIZE_D, MSG_ERR, MainTile->ncycle);
+        MainTile = free_TILE(MainTile);
+        return E_FAIL;
+    }
+    return E_CONTINUE;
+}
+
+/**
+ * Return the output file tag for the current input format, or null if none.
+ * The tag is prefixed by the cluster range if one is selected.
+ */
+static const char * output_tag(void) {
+
+    if (RangeTag != NULL) {return RangeTag;}
+
+    /* different rules for varying input formats */
+    switch (get_input_format()) {
+        case E_TXT:
+            return "seq";
+
+        case E_CIF:
+            return OUTFORM_TEXT[OutputFormat];
+
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * Write a checkpoint of a data block model after the first done of niter iterations.
+ * The name of the current intensities file is stored to identify the tile, since
+ * concatenated output gives every tile the same checkpoint path.
+ * The checkpoint is written to a partial file then renamed so an interrupted write
+ * never replaces a good checkpoint.
+ */
+static void write_checkpoint(const AYB ayb, const CSTRING ckpt, const unsigned int done,
+                             const unsigned int niter, const unsigned int *zerolam) {
+
+    char partpath[strlen(ckpt) + strlen(CKPT_PART) + 1];
+    strcpy(partpath, ckpt);
+    strcat(partpath, CKPT_PART);
+
+    XFILE *fp = xfopen(partpath, XFILE_RAW, "w");
+    if (xfisnull(fp)) {
+        message(E_CHECKPOINT_FAIL_S, MSG_WARN, ckpt);
+        xfclose(fp);
+        return;
+    }
+
+    const CSTRING tilename = get_current_file();
+    const uint32_t namelen = strlen(tilename);
+    const uint32_t iter[2] = {done, niter};
+    bool ok = (xfwrite(CKPT_ID, sizeof(CKPT_ID), 1, fp) == 1)
+              && (xfwrite(&namelen, sizeof(namelen), 1, fp) == 1)
+              && (xfwrite(tilename, 1, namelen, fp) == namelen)
+              && (xfwrite(iter, sizeof(*iter), 2, fp) == 2)
+              && (xfwrite(zerolam, sizeof(*zerolam), done, fp) == done)
+              && write_AYB_state(fp, ayb);
+    xfclose(fp);
+
+    if (!ok || (rename(partpath, ckpt) != 0)) {
+        message(E_CHECKPOINT_FAIL_S, MSG_WARN, ckpt);
+        remove(partpath);
+    }
+}
+
+/**
+ * Read a checkpoint of a data block model of niter iterations into an initialised model,
+ * restoring the zero lambda counts of the completed iterations.
+ * A checkpoint of a different tile is unusable. The model and zero lambda counts
+ * are unchanged unless the whole checkpoint is read.
+ * Returns the number of completed iterations, zero if there is no usable checkpoint.
+ */
+static unsigned int read_checkpoint(AYB ayb, const CSTRING ckpt, const unsigned int niter,
+                                    unsigned int *zerolam) {
+
+    if (access(ckpt, F_OK) != 0) {return 0;}
+
+    XFILE *fp = xfopen(ckpt, XFILE_RAW, "r");
+    if (xfisnull(fp)) {
+        message(E_CHECKPOINT_BAD_S, MSG_WARN, ckpt);
+        xfclose(fp);
+        return 0;
+    }
+
+    const CSTRING tilename = get_current_file();
+    const uint32_t namelen = strlen(tilename);
+    char id[sizeof(CKPT_ID)];
+    char name[namelen + 1];
+    uint32_t len = 0;
+    uint32_t iter[2] = {0, 0};
+    unsigned int lam[niter];
+    bool ok = (xfread(id, sizeof(id), 1, fp) == 1) && (memcmp(id, CKPT_ID, sizeof(id)) == 0)
+              && (xfread(&len, sizeof(len), 1, fp) == 1) && (len == namelen)
+              && (xfread(name, 1, len, fp) == len) && (memcmp(name, tilename, len) == 0)
+              && (xfread(iter, sizeof(*iter), 2, fp) == 2)
+              && (iter[0] > 0) && (iter[0] < niter) && (iter[1] == niter)
+              && (xfread(lam, sizeof(*lam), iter[0], fp) == iter[0])
+              && read_AYB_state(fp, ayb);
+    xfclose(fp);
+
+    if (!ok) {
+        message(E_CHECKPOINT_BAD_S, MSG_WARN, ckpt);
+        return 0;
+    }
+    memcpy(zerolam, lam, iter[0] * sizeof(*zerolam));
+    message(E_CHECKPOINT_RESUME_SD, MSG_INFO, ckpt, iter[0]);
+    return iter[0];
+}
+
+/**
+ * Run the base calling loop on an initialised model, starting after the first done iterations.
+ * If zerolam is supplied the last iteration calls final bases and qualities
+ * and the number of zero lambdas of each iteration is stored in zerolam,
+ * otherwise all iterations are parameter estimation.
+ * If ckpt is supplied the model is checkpointed to it after each iteration but the last.
+ * Returns false if processing terminated on error.
+ */
+static bool run_iterations(AYB ayb, const int blk, const unsigned int done, const unsigned int niter,
+                           unsigned int *zerolam, const CSTRING ckpt) {
+
+    const bool final = (zerolam != NULL);
+
+    int res;
+    real_t resreal;
+    for (int i = done; i < niter; i++){
+        xfprintf(xstdout, "Iteration: %d\n", i+1);
+        xfprintf(xstderr, "Iteration: %d\n", i+1);
+
+        resreal = estimate_MPN(ayb);
+        if (isnan(resreal)) {
+            /* terminate processing */
+            message(E_PROCESS_FAIL_D, MSG_ERR, i + 1);
+            return false;
+        }
+
+        /* parameters to estimate bases are block index and flag to indicate last iteration */
+        /* return is number of zero lambdas or error */
+        res = estimate_bases(ayb, blk, final && (i == (niter - 1)), ShowDebug);
+
+        if (res == DATA_ERR) {
+            /* terminate processing */
+            message(E_PROCESS_FAIL_D, MSG_ERR, i + 1);
+            return false;
+        }
+        else if (final) {
+            zerolam[i] = res;
+            if ((ckpt != NULL) && (i < niter - 1)) {
+                write_checkpoint(ayb, ckpt, i + 1, niter, zerolam);
+            }
+        }
+    }
+    report_AYB_solver(ayb);
+    return true;
+}
+
 /** Output message with counts if any zero lambdas. */
-static void output_zero_lambdas(void) {
+static void output_zero_lambdas(const unsigned int *zerolam) {
 
 static const int MAX_ZEROS = 1e6 - 1;       // Up to 6 digits
 static const int MAX_NUMLEN = 9;            // Enough for "BigNum, \0" or "999999, \0"
@@ -130,7 +345,7 @@ static const char *BIG_NUM = "BigNum";      // Use if number too big for buffer
     /* check if any recorded */
     bool any = false;
     for (int i = 0; i < NIter; i++) {
-        if (ZeroLambda[i] > 0) {
+        if (zerolam[i] > 0) {
             any = true;
             break;
         }
@@ -142,19 +357,19 @@ static const char *BIG_NUM = "BigNum";      // Use if number too big for buffer
         char msgstring[MAX_NUMLEN * NIter];
 
         /* first one has no preceding comma */
-        if (ZeroLambda[0] > MAX_ZEROS) {
+        if (zerolam[0] > MAX_ZEROS) {
             sprintf(msgstring, "%s", BIG_NUM);
         }
         else {
-            sprintf(msgstring, "%d", ZeroLambda[0]);
+            sprintf(msgstring, "%d", zerolam[0]);
         }
 
         for (int i = 1; i < NIter; i++) {
-            if (ZeroLambda[i] > MAX_ZEROS) {
+            if (zerolam[i] > MAX_ZEROS) {
                 sprintf(numstring, ", %s", BIG_NUM);
             }
             else {
-                sprintf(numstring, ", %d", ZeroLambda[i]);
+                sprintf(numstring, ", %d", zerolam[i]);
             }
             strcat(msgstring, numstring);
         }
@@ -164,24 +379,25 @@ static const char *BIG_NUM = "BigNum";      // Use if number too big for buffer
 
 /**
  * Output the results of the base calling.
+ * Provisional results go to a separate file with the output tag prefixed.
  * Returns true if output file opened ok.
  */
-static RETOPT output_results (const AYB ayb, const int blk) {
+static RETOPT output_results (const AYB ayb, const int blk, const bool provisional) {
 
     if (ayb == NULL) {return E_FAIL;}
 
-    XFILE *fpout = NULL;
-    /* different rules for varying input formats */
-    switch (get_input_format()) {
-        case E_TXT:
-            fpout = open_output_blk("seq", blk);
-            break;
+    const char *tag = output_tag();
+    if (tag == NULL) {return E_STOP;}
 
-        case E_CIF:
-            fpout = open_output_blk((CSTRING)OUTFORM_TEXT[OutputFormat], blk);
-            break;
-
-        default: ;
+    XFILE *fpout = NULL;
+    if (provisional) {
+        char provtag[strlen(PROV_TAG) + strlen(tag) + 1];
+        strcpy(provtag, PROV_TAG);
+        strcat(provtag, tag);
+        fpout = open_output_blk(provtag, blk);
+    }
+    else {
+        fpout = open_output_blk((CSTRING)tag, blk);
     }
 
     if (xfisnull(fpout)) {return E_STOP;}
@@ -383,147 +599,445 @@ static void output_simdata(AYB ayb, const int argc, char ** const argv, const in
 }
 
 
-/* public functions */
+/**
+ * Create the model of a data block and set its initial values.
+ * Returns null if the model could not be initialised, setting status to fail
+ * if it could not be created, in which case no further blocks should be analysed.
+ */
+static AYB start_block(const TILE block, const unsigned int ncluster, const int blk,
+                       const unsigned int numblock, RETOPT *status) {
+
+    AYB ayb = new_AYB(block->ncycle, ncluster);
+    if (ayb == NULL) {
+        message(E_NOMEM_S, MSG_FATAL, "model structure creation");
+        message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, block->ncycle);
+        *status = E_FAIL;
+        return NULL;
+    }
+
+    /* get next tile block of raw intensities */
+    ayb = replace_AYB_tile(ayb, block);
+
+    /* set initial model values */
+    const int blkarg = (numblock > 1) ? blk : BLK_SINGLE;
+    if (!initialise_model(ayb, blkarg, ShowDebug)) {
+        message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, get_AYB_ncycle(ayb));
+        return free_AYB(ayb);
+    }
+    message(E_PROCESS_DD, MSG_INFO, blk + 1, get_AYB_ncycle(ayb));
+
+#ifndef NDEBUG
+    if (ShowDebug) {
+        XFILE *fpout = NULL;
+        fpout = open_output_blk("ayb1", blkarg);
+        if (!xfisnull(fpout)) {
+            show_AYB(fpout, ayb, true);
+        }
+        xfclose(fpout);
+    }
+#endif
+
+    return ayb;
+}
 
 /**
- * Analyse a single tile. Intensities data already read in and stored in MainTile.
- * Returns continue if analysis should continue to next file,
- * else fail if to continue to next prefix, else stop.
+ * Run the base calling loop of an initialised data block model,
+ * continuing from its checkpoint if resuming.
  */
-RETOPT analyse_tile (const int argc, char ** const argv) {
+static void model_block(AYB ayb, const int blk, const unsigned int numblock) {
 
-    if (MainTile == NULL) {
-        if (!run_folder()) {
-            /* if not a run-folder then problem caused by bad input file */
-            message(E_BAD_INPUT_S, MSG_ERR, get_current_file());
+    const int blkarg = (numblock > 1) ? blk : BLK_SINGLE;
+    /* a single calling pass if parameters are from lane estimation */
+    const unsigned int niter = get_AYB_callonly(ayb) ? 1 : NIter;
+    unsigned int *zerolam = ZeroLambda + blk * NIter;
+
+    CSTRING ckpt = (Checkpoint || Resume) ? output_path_blk((CSTRING)CKPT_TAG, blkarg) : NULL;
+    unsigned int done = 0;
+    if (Resume && (ckpt != NULL)) {
+        done = read_checkpoint(ayb, ckpt, niter, zerolam);
+    }
+    run_iterations(ayb, blkarg, done, niter, zerolam, Checkpoint ? ckpt : NULL);
+    free_CSTRING(ckpt);
+}
+
+/**
+ * Output the results of a modelled data block.
+ * Returns continue if analysis should continue, otherwise the output status.
+ */
+static RETOPT finish_block(const AYB ayb, const int blk, const unsigned int numblock,
+                           const int argc, char ** const argv) {
+
+    /* output any zero lambdas */
+    output_zero_lambdas(ZeroLambda + blk * NIter);
+
+    /* output the results */
+    const int blkarg = (numblock > 1) ? blk : BLK_SINGLE;
+    RETOPT status = output_results(ayb, blkarg, false);
+
+    /* checkpoint no longer needed once results complete */
+    if ((status == E_CONTINUE) && (Checkpoint || Resume)) {
+        CSTRING ckpt = output_path_blk((CSTRING)CKPT_TAG, blkarg);
+        if (ckpt != NULL) {
+            remove(ckpt);
         }
-        return E_CONTINUE;
+        free_CSTRING(ckpt);
     }
 
-    if (MainTile->ncycle < get_totalcycle()) {
-        /* not enough data */
-        message(E_CYCLESIZE_DD, MSG_ERR, MainTile->ncycle, get_totalcycle());
-        MainTile = free_TILE(MainTile);
-        return E_FAIL;
+    /* output simulation data if requested */
+    if (SimData) {
+        /* block indicator is append if not first of multiple blocks otherwise single */
+        output_simdata(ayb, argc, argv, ((numblock > 1) && (blk > 0)) ? BLK_APPEND : BLK_SINGLE);
     }
-    else if (MainTile->ncycle < MIN_CYCLE) {
-        message(E_CYCLESIZE_D, MSG_ERR, MainTile->ncycle);
-        MainTile = free_TILE(MainTile);
+    return status;
+}
+
+/**
+ * Analyse the data blocks of a tile concurrently, sharing the threads between them.
+ * Models are initialised and output in block order; only the base calling loops overlap,
+ * each using nested parallel regions with its share of the threads.
+ * Returns continue if analysis should continue to next file, else fail.
+ */
+static RETOPT analyse_concurrent(TILE * tileblock, const unsigned int ncluster, const unsigned int numblock,
+                                 const int argc, char ** const argv) {
+
+    RETOPT status = E_CONTINUE;
+    AYB * ayb = calloc(numblock, sizeof(*ayb));
+    if (ayb == NULL) {
+        message(E_NOMEM_S, MSG_FATAL, "model structure creation");
         return E_FAIL;
     }
-    else {
-        message(E_TILESIZE_DD, MSG_INFO, MainTile->ncluster, MainTile->ncycle);
 
-        ShowDebug = false;
+    for (int blk = 0; blk < numblock; blk++) {
+        ayb[blk] = start_block(tileblock[blk], ncluster, blk, numblock, &status);
+        if (status != E_CONTINUE) {goto cleanup;}
+    }
+
+    /* one team per block, up to the number of threads; remainder threads go to the first teams */
+    const int nthread = omp_get_max_threads();
+    const int nteam = ((int)numblock < nthread) ? (int)numblock : nthread;
+    const int levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+    #pragma omp parallel for num_threads(nteam) schedule(dynamic, 1)
+    for (int blk = 0; blk < numblock; blk++) {
+        const int team = omp_get_thread_num();
+        omp_set_num_threads(nthread / nteam + ((team < nthread % nteam) ? 1 : 0));
+        if (ayb[blk] != NULL) {
+            model_block(ayb[blk], blk, numblock);
+        }
+    }
+    omp_set_max_active_levels(levels);
+
+    for (int blk = 0; blk < numblock; blk++) {
+        if (ayb[blk] != NULL) {
+            status = finish_block(ayb[blk], blk, numblock, argc, argv);
+            if (status != E_CONTINUE) {break;}
+        }
+    }
+
+cleanup:
+    for (int blk = 0; blk < numblock; blk++) {
+        free_AYB(ayb[blk]);
+    }
+    xfree(ayb);
+    return status;
+}
+
+/**
+ * Output provisional calls of the first nprov stored cycles, modelled as a single block.
+ * The model starts from the initial values and its parameters are not kept.
+ */
+static void analyse_provisional(const unsigned int nprov) {
+
+    TILE block = view_append_TILE(NULL, MainTile, 0, nprov - 1);
+    if (block == NULL) {
+        message(E_DATABLOCK_FAIL_S, MSG_ERR, get_current_file());
+        return;
+    }
+    message(E_PROVISIONAL_D, MSG_INFO, nprov);
+
+    set_provisional(true);
+    RETOPT status = E_CONTINUE;
+    AYB ayb = start_block(block, block->ncluster, 0, 1, &status);
+    if (ayb != NULL) {
+        unsigned int zerolam[NIter];
+        if (run_iterations(ayb, BLK_SINGLE, 0, NIter, zerolam, NULL)) {
+            output_zero_lambdas(zerolam);
+            output_results(ayb, BLK_SINGLE, true);
+        }
+        ayb = free_AYB(ayb);
+    }
+    set_provisional(false);
+    free_TILE(block);
+}
+
+/**
+ * Read a lane/tile from a run-folder that may still be written, appending the used cycles
+ * to MainTile as their cycle files arrive. Provisional calls are output once the used cycles
+ * among the first RealTime are stored, if the tile is not yet complete.
+ * Gives up, leaving the tile incomplete, if no new cycle arrives within the timeout.
+ */
+static void read_realtime(const char *root, const LANETILE lanetile, const unsigned int ncycle) {
+
+    const bool * use = get_cycle_use();
+    const unsigned int nused = get_usedcycle();
+    bool * want = calloc(ncycle, sizeof(*want));
+    if ((use == NULL) || (want == NULL)) {
+        message(E_NOMEM_S, MSG_FATAL, "real-time cycle selection");
+        xfree(want);
+        return;
+    }
+
+    unsigned int nprov = 0;
+    for (unsigned int cy = 0; (cy < ncycle) && (cy < RealTime); cy++) {
+        if (use[cy]) {nprov++;}
+    }
+    bool provisional = (nprov >= MIN_CYCLE) && (nprov < nused);
+
+    unsigned int next = 0;          // first run cycle not yet stored
+    unsigned int nstored = 0;
+    unsigned int waited = 0;
+    while (nstored < nused) {
+        /* read any used cycles from next on that have arrived */
+        for (unsigned int cy = 0; cy < ncycle; cy++) {
+            want[cy] = use[cy] && (cy >= next);
+        }
+        MainTile = append_folder_TILE(MainTile, root, lanetile.lane, lanetile.tile, want, ncycle);
+        const unsigned int nnew = ((MainTile == NULL) ? 0 : MainTile->ncycle) - nstored;
+        for (unsigned int n = 0; n < nnew; next++) {
+            if (use[next]) {n++;}
+        }
+        nstored += nnew;
+
+        if (provisional && (nstored >= nprov)) {
+            /* not worth it if the tile is complete */
+            if (nstored < nused) {
+                analyse_provisional(nprov);
+            }
+            provisional = false;
+        }
+
+        if (nnew > 0) {
+            waited = 0;
+        }
+        else if (nstored < nused) {
+            if (waited >= CYCLE_TIMEOUT) {break;}
+            if (waited == 0) {
+                message(E_CYCLE_WAIT_DD, MSG_INFO, next + 1, nstored);
+            }
+            sleep(CYCLE_WAIT);
+            waited += CYCLE_WAIT;
+        }
+    }
+    xfree(want);
+}
+
+
+/* public functions */
+
+/**
+ * Analyse a single tile. Intensities data already read in and stored in MainTile.
+ * Returns continue if analysis should continue to next file,
+ * else fail if to continue to next prefix, else stop.
+ */
+RETOPT analyse_tile (const int argc, char ** const argv) {
+
+    RETOPT status = check_tile();
+    if (MainTile == NULL) {return status;}
+
+    message(E_TILESIZE_DD, MSG_INFO, MainTile->ncluster, MainTile->ncycle);
+
+    ShowDebug = false;
 #ifndef NDEBUG
     /* set additional debug output, can overload the process if too much data; vary as required */
     ShowDebug = ((NIter == 1) && (MainTile->ncycle <= 20) && (MainTile->ncluster <= 100));
 #endif
-    }
 
     const unsigned int ncluster = MainTile->ncluster;
     const unsigned int numblock =  get_defaultblock() ? 1 : get_numblock();
-    RETOPT status = E_CONTINUE;
 
-    /* put the data into distinct blocks */
+    /* put the data into distinct blocks; these view the raw data as read in */
     TILE * tileblock = NULL;
     tileblock = create_datablocks(MainTile, numblock);
-    /* no longer need the raw data as read in */
-    MainTile = free_TILE(MainTile);
 
     if (tileblock == NULL) {
         message(E_DATABLOCK_FAIL_S, MSG_FATAL, get_current_file());
+        MainTile = free_TILE(MainTile);
         return E_FAIL;
     }
 
-    /* analyse each tile block separately */
-    AYB ayb = NULL;
-    for (int blk = 0; blk < numblock; blk++) {
+    if (Concurrent && (numblock > 1)) {
+        status = analyse_concurrent(tileblock, ncluster, numblock, argc, argv);
+    }
+    else {
+        /* analyse each tile block separately */
+        AYB ayb = NULL;
+        for (int blk = 0; blk < numblock; blk++) {
+            ayb = start_block(tileblock[blk], ncluster, blk, numblock, &status);
+            if (ayb == NULL) {
+                if (status != E_CONTINUE) {break;}
+                continue;
+            }
 
-        ayb = new_AYB(tileblock[blk]->ncycle, ncluster);
-        if (ayb == NULL) {
-            message(E_NOMEM_S, MSG_FATAL, "model structure creation");
-            message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, tileblock[blk]->ncycle);
-            status = E_FAIL;
-            goto cleanup;
+            model_block(ayb, blk, numblock);
+            status = finish_block(ayb, blk, numblock, argc, argv);
+
+            /* free the structure ready for next */
+            ayb = free_AYB(ayb);
+            if (status != E_CONTINUE) {break;}
         }
+    }
+
+    for (int blk = 0; blk < numblock; blk++)  {
+        free_TILE(tileblock[blk]);
+    }
+    xfree(tileblock);
 
-        /* get next tile block of raw intensities */
-        ayb = replace_AYB_tile(ayb, tileblock[blk]);
+    /* raw data no longer viewed */
+    MainTile = free_TILE(MainTile);
+    return status;
+}
 
-        /* set initial model values */
-        if (initialise_model(ayb, (numblock > 1) ? blk : BLK_SINGLE, ShowDebug)) {
-            message(E_PROCESS_DD, MSG_INFO, blk + 1, get_AYB_ncycle(ayb));
+/**
+ * Return true if resuming and the current tile was completed by an earlier run,
+ * with the results of every data block output and no checkpoint left.
+ * Results concatenated by sample cannot be checked so are never complete.
+ */
+bool completed_tile(void) {
 
-#ifndef NDEBUG
-    if (ShowDebug) {
-        XFILE *fpout = NULL;
-        fpout = open_output_blk("ayb1", (numblock > 1) ? blk : BLK_SINGLE);
-        if (!xfisnull(fpout)) {
-            show_AYB(fpout, ayb, true);
+    if (!Resume || concatenate()) {return false;}
+    const char *tag = output_tag();
+    if (tag == NULL) {return false;}
+
+    const unsigned int numblock =  get_defaultblock() ? 1 : get_numblock();
+    bool complete = true;
+    for (int blk = 0; complete && (blk < numblock); blk++) {
+        const int blkarg = (numblock > 1) ? blk : BLK_SINGLE;
+        CSTRING outpath = output_path_blk((CSTRING)tag, blkarg);
+        CSTRING ckpt = output_path_blk((CSTRING)CKPT_TAG, blkarg);
+        complete = (outpath != NULL) && (ckpt != NULL)
+                   && (access(outpath, F_OK) == 0) && (access(ckpt, F_OK) != 0);
+        free_CSTRING(outpath);
+        free_CSTRING(ckpt);
+    }
+
+    if (complete) {
+        message(E_TILE_COMPLETE_S, MSG_INFO, get_current_file());
+    }
+    return complete;
+}
+
+/**
+ * Add an evenly spaced sample of the clusters of the stored tile to the sample for its lane.
+ * Intensities data already read in and stored in MainTile, which is freed.
+ * Returns continue if sampling should continue to next file,
+ * else fail if to continue to next prefix, else stop.
+ */
+RETOPT sample_tile(void) {
+
+    RETOPT status = check_tile();
+    if (MainTile == NULL) {return status;}
+
+    /* find the sample for this lane or add a new one */
+    unsigned int idx = 0;
+    while ((idx < NLaneTile) && (LaneTile[idx]->lane != MainTile->lane)) {
+        idx++;
+    }
+    if (idx == NLaneTile) {
+        TILE * newlane = realloc(LaneTile, (NLaneTile + 1) * sizeof(*LaneTile));
+        if (newlane == NULL) {
+            message(E_NOMEM_S, MSG_FATAL, "lane sample creation");
+            MainTile = free_TILE(MainTile);
+            return E_STOP;
         }
-        xfclose(fpout);
+        LaneTile = newlane;
+        LaneTile[NLaneTile++] = NULL;
     }
-#endif
 
-            /* base calling loop */
-            int res;
-            real_t resreal;
-            for (int i = 0; i < NIter; i++){
-                xfprintf(xstdout, "Iteration: %d\n", i+1);
-                xfprintf(xstderr, "Iteration: %d\n", i+1);
-
-                resreal = estimate_MPN(ayb);
-                if (isnan(resreal)) {
-                    /* terminate processing */
-                    message(E_PROCESS_FAIL_D, MSG_ERR, i + 1);
-                    break;
-                }
+    LaneTile[idx] = sample_append_TILE(LaneTile[idx], MainTile, LaneSample);
+    MainTile = free_TILE(MainTile);
+    if (LaneTile[idx] == NULL) {
+        message(E_NOMEM_S, MSG_FATAL, "lane sample creation");
+        NLaneTile--;
+        return E_STOP;
+    }
+    return E_CONTINUE;
+}
 
-                /* parameters to estimate bases are block index and flag to indicate last iteration */
-                /* return is number of zero lambdas or error */
-                res = estimate_bases(ayb, (numblock > 1) ? blk : BLK_SINGLE, (i == (NIter - 1)), ShowDebug);
+/**
+ * Estimate model parameters for each sampled lane, then free the samples.
+ * All iterations are parameter estimation; the results are stored for use
+ * in a single calling pass of each tile in the lane.
+ * Tiles of a lane that fails estimation are modelled individually.
+ */
+void estimate_lanes(void) {
 
-                if (res == DATA_ERR) {
-                    /* terminate processing */
-                    message(E_PROCESS_FAIL_D, MSG_ERR, i + 1);
-                    break;
-                }
-                else {
-                    ZeroLambda[i] = res;
-                }
-            }
+    const unsigned int numblock =  get_defaultblock() ? 1 : get_numblock();
 
-            /* output any zero lambdas */
-            output_zero_lambdas();
+    clear_lane_param();
+    set_lane_fitting(true);
+    ShowDebug = false;
 
-            /* output the results */
-            status = output_results(ayb, (numblock > 1) ? blk : BLK_SINGLE);
-            
-            /* output simulation data if requested */
-            if (SimData) {
-                /* block indicator is append if not first of multiple blocks otherwise single */
-                output_simdata(ayb, argc, argv, ((numblock > 1) && (blk > 0)) ? BLK_APPEND : BLK_SINGLE);
-            }
-        }
+    for (unsigned int ln = 0; ln < NLaneTile; ln++) {
+        message(E_LANEFIT_DD, MSG_INFO, LaneTile[ln]->lane, LaneTile[ln]->ncluster);
 
-        else {
-            message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, get_AYB_ncycle(ayb));
+        TILE * tileblock = create_datablocks(LaneTile[ln], numblock);
+        if (tileblock == NULL) {
+            message(E_DATABLOCK_FAIL_S, MSG_ERR, "lane sample");
+            LaneTile[ln] = free_TILE(LaneTile[ln]);
+            continue;
         }
 
-        /* free the structure ready for next */
-        ayb = free_AYB(ayb);
-        if (status != E_CONTINUE) {break;}
-    }
+        for (int blk = 0; blk < numblock; blk++) {
+            AYB ayb = new_AYB(tileblock[blk]->ncycle, tileblock[blk]->ncluster);
+            if (ayb == NULL) {
+                message(E_NOMEM_S, MSG_FATAL, "model structure creation");
+                message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, tileblock[blk]->ncycle);
+                break;
+            }
+            ayb = replace_AYB_tile(ayb, tileblock[blk]);
+
+            const int blkarg = (numblock > 1) ? blk : BLK_SINGLE;
+            if (!initialise_model(ayb, blkarg, false)) {
+                message(E_INIT_FAIL_DD, MSG_ERR, blk + 1, get_AYB_ncycle(ayb));
+            }
+            else if (run_iterations(ayb, blkarg, 0, NIter, NULL, NULL)) {
+                store_lane_param(ayb, blkarg);
+            }
+            ayb = free_AYB(ayb);
+        }
 
-cleanup:
-    if (tileblock != NULL) {
         for (int blk = 0; blk < numblock; blk++)  {
             free_TILE(tileblock[blk]);
         }
         xfree(tileblock);
+        LaneTile[ln] = free_TILE(LaneTile[ln]);
     }
-    return status;
+
+    xfree(LaneTile);
+    LaneTile = NULL;
+    NLaneTile = 0;
+    set_lane_fitting(false);
+}
+
+/** Keep only the selected range of clusters of the stored tile, if any. */
+static void select_clusters(void) {
+
+    if ((ClusterLast > 0) && (MainTile != NULL)) {
+        MainTile = range_TILE(MainTile, ClusterFirst - 1, ClusterLast - 1);
+    }
+}
+
+/** Clear any model parameters carried between tiles, so the next tile starts as a new run. */
+void reset_model(void) {
+
+    clear_warm_start();
+    clear_lane_param();
+}
+
+/** Return true if model parameters are to be estimated per lane before calling each tile. */
+bool lane_estimation(void) {
+    return (LaneSample > 0);
 }
 
 /**
@@ -539,10 +1053,13 @@ void read_intensities_file(XFILE *fp, const LANETILE lanetile, unsigned int ncyc
     switch (get_input_format()) {
         case E_TXT:
             MainTile = read_TILE(fp, ncycle);
+            UsedOnly = false;
             break;
 
         case E_CIF:
-            MainTile = read_cif_TILE (fp, ncycle);
+            /* only store the cycles used */
+            MainTile = read_cif_TILE (fp, get_cycle_use(), ncycle);
+            UsedOnly = (get_cycle_use() != NULL);
 	    MainTile->lane = lanetile.lane;
 	    MainTile->tile = lanetile.tile;
             break;
@@ -550,6 +1067,7 @@ void read_intensities_file(XFILE *fp, const LANETILE lanetile, unsigned int ncyc
         default:
 	    errx(EXIT_FAILURE,"Invalid input format in %s at %s:%d",__func__,__FILE__,__LINE__);
     }
+    select_clusters();
 }
 
 /**
@@ -562,7 +1080,62 @@ void read_intensities_folder(const char *root, const LANETILE lanetile, unsigned
         MainTile = free_TILE(MainTile);
     }
 
-    MainTile = read_folder_TILE(root, lanetile.lane, lanetile.tile, ncycle);
+    if (RealTime > 0) {
+        /* run-folder may still be written */
+        read_realtime(root, lanetile, ncycle);
+    }
+    else {
+        /* only read the cycles used */
+        MainTile = read_folder_TILE(root, lanetile.lane, lanetile.tile, get_cycle_use(), ncycle);
+    }
+    UsedOnly = (get_cycle_use() != NULL);
+    select_clusters();
+}
+
+/**
+ * Set the range of clusters of each tile to call, as first:last counting from one.
+ * Returns false if the range is not two numbers with first no greater than last.
+ */
+bool set_cluster_range(const CSTRING range_str) {
+
+    unsigned int first = 0, last = 0;
+    int nchar = 0;
+    if ((sscanf(range_str, "%u:%u%n", &first, &last, &nchar) != 2) || (range_str[nchar] != '\0')
+        || (first == 0) || (last < first)) {
+        return false;
+    }
+    ClusterFirst = first;
+    ClusterLast = last;
+    return true;
+}
+
+/** Set the data blocks of a tile to be modelled concurrently. */
+void set_concurrent(void) {
+    Concurrent = true;
+}
+
+/** Set the model state not to be checkpointed. */
+void set_nocheckpoint(void) {
+    Checkpoint = false;
+}
+
+/** Set completed tiles to be skipped and data blocks continued from their checkpoints. */
+void set_resume(void) {
+    Resume = true;
+}
+
+/** Set the number of clusters to sample from each tile for lane estimation. */
+bool set_lane_sample(const CSTRING n_str) {
+
+    LaneSample = parse_uint(n_str);
+    return (LaneSample > 0);
+}
+
+/** Set the number of cycles for provisional calls in real-time mode. */
+bool set_realtime(const CSTRING n_str) {
+
+    RealTime = parse_uint(n_str);
+    return (RealTime > 0);
 }
 
 /** Set the number of base call iterations. */
@@ -626,9 +1199,43 @@ bool startup_model(void) {
     }
 
     /* storage for zero lambda count */
-    ZeroLambda = calloc(NIter, sizeof(int));
+    ZeroLambda = calloc(NIter * (get_defaultblock() ? 1 : numblock), sizeof(*ZeroLambda));
 
     message(E_OPT_SELECT_SD, MSG_INFO, "iterations", NIter);
+    if (LaneSample > 0) {
+        message(E_OPT_SELECT_SD, MSG_INFO, "clusters per tile for lane estimation", LaneSample);
+    }
+    if (Concurrent) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Data block analysis", "concurrent");
+    }
+    if (ClusterLast > 0) {
+        /* shards of a tile must be called independently of the other clusters */
+        if (!param_bundle() || spike_in() || (RealTime > 0)) {
+            message(E_BAD_TXT_SS, MSG_FATAL, "Cluster range option",
+                    "needs a parameter bundle, without spike-in data or realtime option");
+            return false;
+        }
+        const char *tag = output_tag();
+        if (tag != NULL) {
+            RangeTag = new_CSTRING(strlen(tag) + RANGE_LEN);
+            sprintf(RangeTag, "c%u-%u.%s", ClusterFirst, ClusterLast, tag);
+        }
+        message(E_CLUSTER_RANGE_DD, MSG_INFO, ClusterFirst, ClusterLast);
+    }
+    if (!Checkpoint) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Model checkpoint", "none");
+    }
+    if (Resume) {
+        message(E_OPT_SELECT_SS, MSG_INFO, "Resume", "skip completed tiles, continue from checkpoints");
+    }
+    if (RealTime > 0) {
+        /* need the cycles of the run to wait for */
+        if (!run_folder() || get_defaultblock()) {
+            message(E_BAD_TXT_SS, MSG_FATAL, "Realtime option", "needs run-folder input and a blockstring");
+            return false;
+        }
+        message(E_OPT_SELECT_SD, MSG_INFO, "cycles for real-time provisional calls", RealTime);
+    }
 
     return startup_ayb();
 }
@@ -638,6 +1245,11 @@ void tidyup_model(void) {
 
     /* free memory */
     SimText = free_CSTRING(SimText);
+    RangeTag = free_CSTRING(RangeTag);
     xfree(ZeroLambda);
+    for (unsigned int ln = 0; ln < NLaneTile; ln++) {
+        free_TILE(LaneTile[ln]);
+    }
+    xfree(LaneTile);
     tidyup_ayb();
 }
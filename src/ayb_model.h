@@ -36,9 +36,20 @@
 /* function prototypes */
 
 RETOPT analyse_tile (const int argc, char ** const argv);
+bool completed_tile(void);
+void estimate_lanes(void);
+bool lane_estimation(void);
+RETOPT sample_tile(void);
 void read_intensities_file(XFILE *fp, const LANETILE lanetile, unsigned int ncycle);
 void read_intensities_folder(const char *root, LANETILE lanetile, unsigned int ncycle);
+void reset_model(void);
+bool set_cluster_range(const CSTRING range_str);
+void set_concurrent(void);
+bool set_lane_sample(const CSTRING n_str);
 bool set_niter(const CSTRING niter_str);
+void set_nocheckpoint(void);
+bool set_realtime(const CSTRING n_str);
+void set_resume(void);
 bool set_output_format(const char *outform_str);
 void set_simdata(const CSTRING simdata_str);
 bool startup_model(void);
@@ -71,6 +71,7 @@ void print_usage(FILE *fp) {
 
 /* members */
 static int NThread = 1;
+static int NWorker = 1;
 
 
 /** Options with no short form. */
@@ -86,6 +87,7 @@ static struct option Longopts[] = {
     {"logfile",     required_argument,  NULL, 'e'},
     {"format",      required_argument,  NULL, 'f'},
     {"input",       required_argument,  NULL, 'i'},
+    {"concurrent",  no_argument,        NULL, 'j'},
     {"spikeuse",    no_argument,        NULL, 'k'},
     {"loglevel",    required_argument,  NULL, 'l'},
     {"mu",          required_argument,  NULL, 'm'},
@@ -95,14 +97,27 @@ static struct option Longopts[] = {
     {"noqualout",   no_argument,        NULL, 'q'},
     {"runfolder",   no_argument,        NULL, 'r'},
     {"thin",        required_argument,  NULL, 't'},
+    {"spool",       required_argument,  NULL, 'u'},
     {"working",     required_argument,  NULL, 'w'},
+    {"workers",     required_argument,  NULL, 'x'},
     {"zerothin",    required_argument,  NULL, 'z'},
+    {"warmstart",   required_argument,  NULL, 'W'},
     {"A",           required_argument,  NULL, 'A'},
+    {"bundle",      required_argument,  NULL, 'B'},
+    {"nocheckpoint",no_argument,        NULL, 'C'},
+    {"solver",      required_argument,  NULL, 'E'},
     {"spikein",     required_argument,  NULL, 'K'},
+    {"lanefit",     required_argument,  NULL, 'L'},
     {"M",           required_argument,  NULL, 'M'},
     {"N",           required_argument,  NULL, 'N'},
+    {"precision",   required_argument,  NULL, 'P'},
     {"qualtab",     required_argument,  NULL, 'Q'},
+    {"realtime",    required_argument,  NULL, 'R'},
     {"samplename",  required_argument,  NULL, 'S'},
+    {"thintarget",  required_argument,  NULL, 'T'},
+    {"clusterrange",required_argument,  NULL, 'X'},
+    {"thinseed",    required_argument,  NULL, 'Y'},
+    {"resume",      no_argument,        NULL, 'Z'},
     {"help",        no_argument,        NULL, OPT_HELP },
     {"licence",     no_argument,        NULL, OPT_LICENCE },
     {"license",     no_argument,        NULL, OPT_LICENCE },
@@ -133,6 +148,22 @@ static void set_nthread(const CSTRING n_str) {
 }
 
 
+/** 
+ * Set the requested number of worker processes.
+ * Do not allow to be invalid.
+ */
+static void set_nworker(const CSTRING n_str) {
+
+    unsigned int n = parse_uint(n_str);
+    if (n > 0) {
+        NWorker = n;
+    }
+    else {
+        fprintf(stderr, "Warning: Invalid number of workers ('%s') supplied; defaulting to %d\n", n_str, NWorker);
+    }
+}
+
+
 /* public functions */
 
 /**
@@ -149,7 +180,7 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
     /* act on each option in turn */
     int ch;
 
-    while ((ch = getopt_long(argc, argv, "s:b:cd:e:f:g:i:kl:m:n:o:p:qrt:w:z:A:K:M:N:Q:S:", Longopts, NULL)) != -1){
+    while ((ch = getopt_long(argc, argv, "s:b:cd:e:f:g:i:jkl:m:n:o:p:qrt:u:w:x:z:A:B:CE:K:L:M:N:P:Q:R:S:T:W:X:Y:Z", Longopts, NULL)) != -1){
 
         switch(ch){
             case 's':
@@ -203,6 +234,11 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
                 set_location(optarg, E_INPUT);
                 break;
 
+            case 'j':
+                /* model data blocks concurrently */
+                set_concurrent();
+                break;
+
             case 'k':
                 /* spike-in data calibration flag */
                 set_spike_calib();
@@ -260,6 +296,11 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
                 }
                 break;
 
+            case 'u':
+                /* spool directory of jobs for service mode */
+                set_location(optarg, E_SPOOL);
+                break;
+
             case 'w':
                 /* show working output level */
                 if (!set_show_working(optarg)) {
@@ -268,6 +309,11 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
                 }
                 break;
 
+            case 'x':
+                /* requested number of worker processes */
+                set_nworker(optarg);
+                break;
+
             case 'z':
                 /* limit for cycles with missing data */
                 if (!set_zerothin_limit(optarg)) {
@@ -281,11 +327,37 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
                 set_location(optarg, E_PARAMA);
                 break;
 
+            case 'B':
+                /* parameter bundle files for call only */
+                set_param_bundle(optarg);
+                break;
+
+            case 'C':
+                /* do not checkpoint the model state */
+                set_nocheckpoint();
+                break;
+
+            case 'E':
+                /* solver of the parameter estimation equations */
+                if (!set_solver(optarg)) {
+                    fprintf(stderr, "Fatal: Unrecognised --solver option: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
             case 'K':
                 /* location of spike-in data */
                 set_location(optarg, E_SPIKEIN);
                 break;
 
+            case 'L':
+                /* lane estimation of model parameters from a sample of each tile */
+                if (!set_lane_sample(optarg)) {
+                    fprintf(stderr, "Fatal: Illegal --lanefit sample size: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
             case 'M':
                 /* initial crosstalk file name */
                 set_location(optarg, E_CROSSTALK);
@@ -296,16 +368,69 @@ RETOPT read_options(const int argc, char ** const argv, int *nextarg) {
                 set_location(optarg, E_NOISE);
                 break;
 
+            case 'P':
+                /* floating point precision of base calling */
+                if (!set_precision(optarg)) {
+                    fprintf(stderr, "Fatal: Unrecognised --precision option: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
             case 'Q':
                 /* quality calibration conversion table file location */
                 set_location(optarg, E_QUALTAB);
                 break;
 
+            case 'R':
+                /* cycles for provisional calls while the run-folder is written */
+                if (!set_realtime(optarg)) {
+                    fprintf(stderr, "Fatal: Illegal --realtime number of cycles: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
 	    case 'S':
 		/* Sample name */
 		set_sample_name(optarg);
 		break;
 
+            case 'T':
+                /* target number of clusters for parameter estimation */
+                if (!set_thin_target(optarg)) {
+                    fprintf(stderr, "Fatal: Illegal --thintarget number: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
+            case 'W':
+                /* warm start model parameters from previous tiles */
+                if (!set_warm_start(optarg)) {
+                    fprintf(stderr, "Fatal: Unrecognised --warmstart option: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
+            case 'X':
+                /* range of clusters to call from each tile */
+                if (!set_cluster_range(optarg)) {
+                    fprintf(stderr, "Fatal: Illegal --clusterrange, need first:last: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
+            case 'Y':
+                /* random seed for thinning to target */
+                if (!set_thin_seed(optarg)) {
+                    fprintf(stderr, "Fatal: Illegal --thinseed value: \'%s\'\n\n", optarg);
+                    status = E_FAIL;
+                }
+                break;
+
+            case 'Z':
+                /* continue an interrupted run */
+                set_resume();
+                break;
+
             case OPT_HELP:
                 print_usage(stderr);
                 print_help(stderr);
@@ -341,6 +466,12 @@ int get_nthread(void) {
     return NThread;
 }
 
+/** Return the requested number of worker processes. */
+int get_nworker(void) {
+
+    return NWorker;
+}
+
 /**
  * Return true if supplied string matches long or short form of supplied option structure index.
  * Only some indexes identified in OptIndexT enum.
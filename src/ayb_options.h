@@ -41,6 +41,7 @@ typedef enum OptIndexT {E_SIMDATA = 0} OPTINDEX;
 
 RETOPT read_options(const int argc, char ** const argv, int *nextarg);
 int get_nthread(void);
+int get_nworker(void);
 bool match_option(const char *string, const OPTINDEX index);
 
 #endif /* AYB_OPTIONS_H_ */
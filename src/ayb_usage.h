@@ -10,10 +10,12 @@ PROGNAME " Advanced Base Calling for Next-Generation Sequencing Machines\n"
 "\n"
 "Usage:\n"
 "\t" PROGNAME " [-b blockstring] [-d input format] [-e log file] [-f output format]\n"
-"\t    [-g generr] [-i input path] [-k] [-l log level] [-n iterations]\n"
+"\t    [-g generr] [-i input path] [-j] [-k] [-l log level] [-n iterations]\n"
 "\t    [-o output path] [-p threads] [-q] [-r] [-s header] [-t factor]\n"
-"\t    [-w level] [-z limit] [-A Parameter A] [-K spike-in path]\n"
-"\t    [-M Crosstalk] [-N Noise] [-Q quality tab] [-S sample name]\n"
+"\t    [-u spool path] [-w level] [-x workers] [-z limit] [-A Parameter A]\n"
+"\t    [-B bundle] [-C] [-E solver] [-K spike-in path] [-L lane sample] [-M Crosstalk]\n"
+"\t    [-N Noise] [-P precision] [-Q quality tab] [-R cycles] [-S sample name]\n"
+"\t    [-T target] [-W warm start] [-X first:last] [-Y seed] [-Z]\n"
 "\t    <prefix[+]/lane tile range> [<prefix[+]/lane tile range> ...]\n"
 "\t" PROGNAME " --help\n"
 "\t" PROGNAME " --licence\n"
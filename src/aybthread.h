@@ -13,6 +13,18 @@
 	}
 
 	static inline void omp_set_num_threads(int t){}
+
+	static inline int omp_get_max_active_levels(void){
+		return 1;
+	}
+
+	static inline void omp_set_max_active_levels(int l){}
+
+	typedef enum omp_pause_resource_t {omp_pause_soft = 1, omp_pause_hard = 2} omp_pause_resource_t;
+
+	static inline int omp_pause_resource_all(omp_pause_resource_t kind){
+		return 0;
+	}
 #endif
 
 #endif /* AYBTHREAD_H */
@@ -24,12 +24,32 @@
  */
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
+#include <string.h>
 #include "call_bases.h"
 
 
 /* constants */
-/* None      */
+
+static const int OMBAND = 2 * NBASE * NBASE;   ///< Values per cycle in an omega band table.
+static const int NPROJ = 3 * NBASE;             ///< Values per cycle in projected intensities.
+
+/* Polynomial exp and log of the quality calculation; coefficients and reductions as fdlibm. */
+static const real_t LN2_HI = 6.93147180369123816490e-01;    ///< High part of log(2), exact multiples.
+static const real_t LN2_LO = 1.90821492927058770002e-10;    ///< Low part of log(2).
+static const real_t INV_LN2 = 1.44269504088896338700e+00;   ///< 1/log(2).
+static const real_t ROUND_MAGIC = 6755399441055744.0;       ///< 1.5 * 2^52, rounds to integer when added.
+static const real_t EXP_MIN = -708.0;                       ///< Polynomial exp range, normal results.
+static const real_t EXP_MAX = 709.0;
+static const real_t EXP_P[] = {1.66666666666666019037e-01, -2.77777777770155933842e-03, 6.61375632143793436117e-05,
+                               -1.65339022054652515390e-06, 4.13813679705723846039e-08};
+static const real_t LOG_LG[] = {6.666666666666735130e-01, 3.999999999940941908e-01, 2.857142874366239149e-01,
+                                2.222219843214978396e-01, 1.818357216161805012e-01, 1.531383769920937332e-01,
+                                1.479819860511658591e-01};
+static const int64_t EXPONENT_ONE = 0x3ff0000000000000;     ///< Bits of 1.0.
+static const int64_t MANTISSA_MASK = 0x000fffffffffffff;    ///< Mantissa bits of a double.
+static const int64_t SQRT2_MANTISSA = 0x0006a09e667f3bcd;   ///< Mantissa bits of sqrt(2).
 
 /* members */
 
@@ -40,43 +60,245 @@ static real_t PolyQual = 38.0;                  ///< Generalised error value, ad
 /* private functions */
 
 /**
- * Subcalculation for call_bases.
- * Returns -2*I_b^t om p + lambda * I_b^t om I^b, where I_b is indicator vector of base b.
- * - p:        Intensities of i^th cycle
- * - lambda:   Brightness of cluster
- * - b:        Putative base
- * - om:       Pointer to first entry of i^th block on the diagonal of Omega; lda of Omega is NBASE*ncycle
+ * Project the processed intensities of a cluster onto an omega band table, once per cluster.
+ * For cycle i holds, in order:
+ * - d = Om_{ii} p_i
+ * - u = Om_{i-1,i}^t p_{i-1}
+ * - v = Om_{i-1,i} p_i
+ *
+ * where Om_{i-1,i} is the block linking cycle i-1 to i; u and v of the first cycle are zero.
+ * Returns p^t Om p, which these products also give.
  */
-static real_t baselike (const real_t * restrict p, const real_t lambda, const NUC b, const real_t * om, const int ncycle){
-    if (NULL==p || NULL==om || !isfinite(lambda) || NUC_AMBIG==b) { return NAN;}
+static real_t project_intensities(const real_t * restrict p, const int ncycle, const real_t * restrict omtab, real_t * restrict proj){
+    real_t pOp = 0.0;
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const real_t * pc = p + cy*NBASE;
+        const real_t * diag = omtab + cy*OMBAND;
+        real_t * d = proj + cy*NPROJ;
+        real_t * u = d + NBASE;
+        real_t * v = d + 2*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            d[a] = 0.0;
+            for ( int i=0 ; i<NBASE ; i++){
+                d[a] += pc[i]*diag[a*NBASE+i];
+            }
+            pOp += pc[a]*d[a];
+        }
+        if (cy==0) {
+            for ( int a=0 ; a<NBASE ; a++){ u[a] = 0.0; v[a] = 0.0; }
+            continue;
+        }
+        const real_t * pp = pc - NBASE;
+        const real_t * cross = omtab + (cy-1)*OMBAND + NBASE*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            u[a] = 0.0;
+            v[a] = 0.0;
+            for ( int i=0 ; i<NBASE ; i++){
+                u[a] += pp[i]*cross[i*NBASE+a];
+                v[a] += pc[i]*cross[a*NBASE+i];
+            }
+            pOp += 2.0*pc[a]*u[a];
+        }
+    }
+    return pOp;
+}
 
-    const int lda = NBASE*ncycle;
-    real_t like = lambda*om[b*lda+b];
-    for ( int i=0 ; i<NBASE ; i++){
-        like -= 2.0* p[i]*om[b*lda+i];
+/** Single precision version of project_intensities, without p^t Om p. */
+static void project_intensities_f(const float * restrict p, const int ncycle, const float * restrict omband, float * restrict proj){
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const float * pc = p + cy*NBASE;
+        const float * diag = omband + cy*OMBAND;
+        float * d = proj + cy*NPROJ;
+        float * u = d + NBASE;
+        float * v = d + 2*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            d[a] = 0.0f;
+            for ( int i=0 ; i<NBASE ; i++){
+                d[a] += pc[i]*diag[a*NBASE+i];
+            }
+        }
+        if (cy==0) {
+            for ( int a=0 ; a<NBASE ; a++){ u[a] = 0.0f; v[a] = 0.0f; }
+            continue;
+        }
+        const float * pp = pc - NBASE;
+        const float * cross = omband + (cy-1)*OMBAND + NBASE*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            u[a] = 0.0f;
+            v[a] = 0.0f;
+            for ( int i=0 ; i<NBASE ; i++){
+                u[a] += pp[i]*cross[i*NBASE+a];
+                v[a] += pc[i]*cross[a*NBASE+i];
+            }
+        }
     }
-    return like;
 }
 
 /**
- * Subcalculation for call_bases.
- * Returns lambda I_b^t om I_a - p_{i+1}^t om p_{i} - p_{i}^t om p_{i+1}^t, where I_b/a is indicator vector of base b/a.
- * - p:        Intensities of i^th cycle
- * - lambda:   Brightness of cluster
- * - a:        Putative base for cycle i
- * - b:        Putative base for cycle i+1
- * - om:       Pointer to first entry of i^th block on the lower diagonal of Omega; lda of Omega is NBASE*ncycle
+ * Fill the cost arrays used by the dynamic programming algorithms from projected intensities.
+ * basecost[4*cy+b] is -2*I_b^t Om_{ii} p_i + lambda * I_b^t Om_{ii} I_b for base b at cycle cy.
+ * crosscost[16*cy+4*a+b] is lambda I_a^t Om_{i-1,i} I_b - p_{i-1}^t Om_{i-1,i} I_b - I_a^t Om_{i-1,i} p_i
+ * for base a at cycle cy-1 followed by base b at cycle cy (entries of cycle zero are unused).
+ * Costs are NAN if lambda is not finite.
  */
-static real_t crosslike(const real_t * restrict p, const real_t lambda, const NUC a, const NUC b, const real_t * om, const int ncycle){
-    if (NULL==p || NULL==om || !isfinite(lambda) || NUC_AMBIG==a || NUC_AMBIG==b) { return NAN;}
+static void fill_costs(const real_t * restrict proj, const int ncycle, const real_t lambda, const real_t * restrict omtab,
+                       real_t * restrict basecost, real_t * restrict crosscost){
+    const real_t lam = isfinite(lambda) ? lambda : NAN;
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const real_t * diag = omtab + cy*OMBAND;
+        const real_t * d = proj + cy*NPROJ;
+        for ( int b=0 ; b<NBASE ; b++){
+            basecost[4*cy+b] = lam*diag[b*NBASE+b] - 2.0*d[b];
+        }
+        if (cy==0) { continue; }
+        const real_t * cross = omtab + (cy-1)*OMBAND + NBASE*NBASE;
+        const real_t * u = d + NBASE;
+        const real_t * v = d + 2*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            for ( int b=0 ; b<NBASE ; b++){
+                crosscost[16*cy+4*a+b] = lam*cross[a*NBASE+b] - u[b] - v[a];
+            }
+        }
+    }
+}
 
-    const int lda = NBASE*ncycle;
-    real_t like = lambda*om[a*lda+b];
-    for ( int i=0 ; i<NBASE ; i++){
-        like -= p[i]*om[i*lda+b];
-        like -= p[NBASE+i]*om[a*lda+i];
+/** Single precision version of fill_costs for mixed precision calling. */
+static void fill_costs_f(const float * restrict proj, const int ncycle, const float lambda, const float * restrict omband,
+                         float * restrict basecost, float * restrict crosscost){
+    const float lam = isfinite(lambda) ? lambda : NAN;
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const float * diag = omband + cy*OMBAND;
+        const float * d = proj + cy*NPROJ;
+        for ( int b=0 ; b<NBASE ; b++){
+            basecost[4*cy+b] = lam*diag[b*NBASE+b] - 2.0f*d[b];
+        }
+        if (cy==0) { continue; }
+        const float * cross = omband + (cy-1)*OMBAND + NBASE*NBASE;
+        const float * u = d + NBASE;
+        const float * v = d + 2*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            for ( int b=0 ; b<NBASE ; b++){
+                crosscost[16*cy+4*a+b] = lam*cross[a*NBASE+b] - u[b] - v[a];
+            }
+        }
+    }
+}
+
+/**
+ * Exponential of an array, y = exp(x); x and y must not overlap.
+ * Straight line polynomial code that the compiler vectorises across the lanes of the
+ * instruction set of the calling HOT_KERNEL; arguments outside [EXP_MIN, EXP_MAX]
+ * (including NaN) give any value in that loop and are then recomputed with libm.
+ * Within 1 ulp of the exact result, so within 2 ulp of libm.
+ */
+static inline void exp_array(const real_t * restrict x, const int n, real_t * restrict y){
+    for ( int i=0 ; i<n ; i++){
+        const real_t xc = x[i];
+        // reduce to x = k log(2) + r, |r| <= log(2)/2
+        const real_t t = xc*INV_LN2 + ROUND_MAGIC;
+        const real_t k = t - ROUND_MAGIC;
+        const real_t hi = xc - k*LN2_HI;
+        const real_t lo = k*LN2_LO;
+        const real_t r = hi - lo;
+        const real_t rr = r*r;
+        const real_t c = r - rr*(EXP_P[0]+rr*(EXP_P[1]+rr*(EXP_P[2]+rr*(EXP_P[3]+rr*EXP_P[4]))));
+        const real_t er = 1.0 - ((lo - (r*c)/(2.0-c)) - hi);
+        // scale by 2^k, k is held in the low bits of t
+        uint64_t tbits, mbits;
+        memcpy(&tbits, &t, sizeof(t));
+        memcpy(&mbits, &ROUND_MAGIC, sizeof(ROUND_MAGIC));
+        const uint64_t sbits = (tbits - mbits + 1023) << 52;
+        real_t scale;
+        memcpy(&scale, &sbits, sizeof(scale));
+        y[i] = er*scale;
+    }
+    for ( int i=0 ; i<n ; i++){
+        if (!(x[i]>=EXP_MIN && x[i]<=EXP_MAX)) { y[i] = exp(x[i]); }
+    }
+}
+
+/**
+ * Log of one plus an array, y = log(1+x); x and y must not overlap.
+ * Vectorised as exp_array; 1+x outside the normal positive range (including NaN) is
+ * recomputed with libm log1p.
+ * Within 1 ulp of log(1+x) for the rounded 1+x, so within 2 ulp of libm
+ * plus the rounding of 1+x, at most DBL_EPSILON/2 in the result.
+ */
+static inline void log1p_array(const real_t * restrict x, const int n, real_t * restrict y){
+    for ( int i=0 ; i<n ; i++){
+        const real_t v = 1.0 + x[i];
+        // reduce to v = 2^k m, sqrt(2)/2 <= m < sqrt(2), selecting on integer bits
+        int64_t vbits;
+        memcpy(&vbits, &v, sizeof(v));
+        const int64_t mant = vbits & MANTISSA_MASK;
+        const int64_t big = (mant >= SQRT2_MANTISSA) ? 1 : 0;
+        const int64_t ebits = ((vbits >> 52) + big) | 0x4330000000000000;
+        const int64_t mbits = mant | (EXPONENT_ONE - (big << 52));
+        real_t e, m;
+        memcpy(&e, &ebits, sizeof(e));
+        memcpy(&m, &mbits, sizeof(m));
+        const real_t k = (e - 4503599627370496.0) - 1023.0;
+        // log(m) = log(1+f) from s = f/(2+f)
+        const real_t f = m - 1.0;
+        const real_t s = f/(2.0+f);
+        const real_t z = s*s;
+        const real_t w = z*z;
+        const real_t t1 = w*(LOG_LG[1]+w*(LOG_LG[3]+w*LOG_LG[5]));
+        const real_t t2 = z*(LOG_LG[0]+w*(LOG_LG[2]+w*(LOG_LG[4]+w*LOG_LG[6])));
+        const real_t R = t2 + t1;
+        const real_t hfsq = 0.5*f*f;
+        y[i] = k*LN2_HI - ((hfsq - (s*(hfsq+R) + k*LN2_LO)) - f);
+    }
+    for ( int i=0 ; i<n ; i++){
+        const real_t v = 1.0 + x[i];
+        if (!(v>=DBL_MIN && v<=DBL_MAX)) { y[i] = log1p(x[i]); }
+    }
+}
+
+/**
+ * Posterior qualities of the called bases from the statistics of all bases,
+ * stat[4*cy+b] = p^t Om p + lambda * (fwds + bwds + base cost).
+ * The probability of the called base at each cycle is
+ * 1 / sum_b ((1+stat_called)/(1+stat_b))^((1+effDF)/2) times the generalised error,
+ * converted to a phred quality value.
+ * Uses the polynomial exp and log; compared to libm the quality values agree to within
+ * 1e-6, far below the rounding of a phred character (validated by test-call_bases).
+ */
+HOT_KERNEL static void posterior_qualities(const real_t * restrict stat, const int ncycle, const NUC * base, const real_t effDF, real_t * qual){
+    const real_t polyErr = -expm1(-PolyQual/10.0 * log(10.0));
+    const real_t scale = -0.5*(1.0+effDF);
+    const int n = 4*ncycle;
+
+    // log1p of all statistics; the called base gives log1p(xmax)
+    real_t lstat[n], arg[n], term[n];
+    log1p_array(stat, n, lstat);
+    for ( int i=0 ; i<n ; i++){
+        arg[i] = scale*(lstat[i]-lstat[(i & ~3)+base[i>>2]]);
+    }
+    exp_array(arg, n, term);
+
+    // probability of called base, as log1p(-prob) for quality
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        real_t sum = 0.0;
+        for ( int b=0 ; b<4 ; b++){
+            sum += term[4*cy+b];
+        }
+        real_t prob = 1.0 / sum;
+        prob *= polyErr;
+        arg[cy] = -prob;
+    }
+    log1p_array(arg, ncycle, term);
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        qual[cy] = -10.*term[cy]/log(10.);
+    }
+}
+
+/** Copy processed intensities into single precision. */
+static void float_from_MAT(const MAT p, float * restrict pf){
+    const uint_fast32_t n = p->nrow * p->ncol;
+    for ( uint_fast32_t i=0 ; i<n ; i++){
+        pf[i] = (float)p->x[i];
     }
-    return like;
 }
 
 /** Maximum of n real_ts. Should possibly be moved into utility.h library. */
@@ -90,6 +312,175 @@ static inline int max_real_t(const real_t * restrict p, const uint32_t n){
     return idx;
 }
 
+/**
+ * Viterbi algorithm over precomputed cost arrays.
+ * Returns min A (see call_bases).
+ */
+static real_t viterbi_costs(const real_t * restrict basecost, const real_t * restrict crosscost, const int ncycle, NUC * base){
+    real_t array[NBASE*ncycle];
+    for ( int b=0 ; b<NBASE ; b++){
+        array[b] = basecost[b];
+    }
+    for ( int cy=1; cy<ncycle ; cy++){
+        NUC precall[NBASE];
+        for ( int b=0 ; b<NBASE ; b++){
+            real_t minstat = HUGE_VAL;
+            int minidx = 0;
+            for ( int prev=0 ; prev<NBASE ; prev++){
+                real_t stat = basecost[4*cy+b] + array[(cy-1)*NBASE+prev] + 2.0*crosscost[16*cy+4*prev+b];
+                if(stat<minstat){
+                    minidx = prev;
+                    minstat = stat;
+                }
+            }
+            array[cy*NBASE+b] = minstat;
+            precall[b] = minidx;
+        }
+        for ( int b=0 ; b<NBASE ; b++){
+            array[(cy-1)*NBASE+b] = precall[b];
+        }
+    }
+
+    real_t minstat = HUGE_VAL;
+    int minidx = 0;
+    for ( int b=0 ; b<NBASE ; b++){
+        if(array[(ncycle-1)*NBASE+b]<minstat){ minidx = b; minstat = array[(ncycle-1)*NBASE+b];}
+    }
+    base[ncycle-1] = minidx;
+    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
+        base[cy] = (NUC)array[cy*NBASE+base[cy+1]];
+    }
+    return minstat;
+}
+
+/** Single precision version of viterbi_costs. */
+static float viterbi_costs_f(const float * restrict basecost, const float * restrict crosscost, const int ncycle, NUC * base){
+    float array[NBASE*ncycle];
+    for ( int b=0 ; b<NBASE ; b++){
+        array[b] = basecost[b];
+    }
+    for ( int cy=1; cy<ncycle ; cy++){
+        NUC precall[NBASE];
+        for ( int b=0 ; b<NBASE ; b++){
+            float minstat = HUGE_VALF;
+            int minidx = 0;
+            for ( int prev=0 ; prev<NBASE ; prev++){
+                float stat = basecost[4*cy+b] + array[(cy-1)*NBASE+prev] + 2.0f*crosscost[16*cy+4*prev+b];
+                if(stat<minstat){
+                    minidx = prev;
+                    minstat = stat;
+                }
+            }
+            array[cy*NBASE+b] = minstat;
+            precall[b] = minidx;
+        }
+        for ( int b=0 ; b<NBASE ; b++){
+            array[(cy-1)*NBASE+b] = precall[b];
+        }
+    }
+
+    float minstat = HUGE_VALF;
+    int minidx = 0;
+    for ( int b=0 ; b<NBASE ; b++){
+        if(array[(ncycle-1)*NBASE+b]<minstat){ minidx = b; minstat = array[(ncycle-1)*NBASE+b];}
+    }
+    base[ncycle-1] = minidx;
+    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
+        base[cy] = (NUC)array[cy*NBASE+base[cy+1]];
+    }
+    return minstat;
+}
+
+/**
+ * Posterior qualities of called bases via fwds/bwds over precomputed cost arrays.
+ * - pOp:      Quadratic form p^t Om p
+ */
+static void qualities_costs(const real_t * restrict basecost, const real_t * restrict crosscost, const int ncycle,
+                            const real_t lambda, const real_t pOp, const real_t effDF, const NUC * base, real_t * qual){
+    // arrays contain accumulation information
+    real_t farray[4*ncycle], barray[4*ncycle];
+
+    // Forwards piece of algorithm.
+    // Initalise
+    for ( int b=0 ; b<4 ; b++){ farray[b] = 0.0; }
+    // Iteration
+    for ( int cy=1; cy<ncycle ; cy++){
+        for ( int b=0 ; b<NBASE ; b++){
+            farray[4*cy+b] = HUGE_VAL;
+            // Find minimum for past calls give current call
+            for ( int prev=0 ; prev<4 ; prev++){
+                real_t callLS = basecost[4*(cy-1)+prev] + farray[4*(cy-1)+prev] + 2.0*crosscost[16*cy+4*prev+b];
+                if(callLS<farray[4*cy+b]){ farray[4*cy+b] = callLS; }
+            }
+        }
+    }
+
+    // Backwards piece of algorithm.
+    // Initialise
+    for ( int b=0 ; b<4 ; b++){ barray[(ncycle-1)*4+b] = 0.0; }
+    // Iteration
+    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
+        for ( int b=0 ; b<NBASE ; b++){
+            barray[4*cy+b] = HUGE_VAL;
+            // Find minimum for future calls given current call
+            for ( int nxt=0 ; nxt<4 ; nxt++){
+                real_t callLS = basecost[4*(cy+1)+nxt] + barray[4*(cy+1)+nxt] + 2.0*crosscost[16*(cy+1)+4*b+nxt];
+                if(callLS<barray[4*cy+b]){ barray[4*cy+b] = callLS; }
+            }
+        }
+    }
+
+    real_t stat[4*ncycle];
+    for ( int i=0 ; i<4*ncycle ; i++){
+        stat[i] = farray[i] + barray[i] + basecost[i];
+        stat[i] *= lambda;
+        stat[i] += pOp;
+    }
+    posterior_qualities(stat, ncycle, base, effDF, qual);
+}
+
+/**
+ * Single precision version of qualities_costs.
+ * The fwds/bwds recursions are single precision; the per-base
+ * statistics and the posterior probability sums are formed in double.
+ */
+static void qualities_costs_f(const float * restrict basecost, const float * restrict crosscost, const int ncycle,
+                              const real_t lambda, const real_t pOp, const real_t effDF, const NUC * base, real_t * qual){
+    float farray[4*ncycle], barray[4*ncycle];
+
+    // Forwards piece of algorithm.
+    for ( int b=0 ; b<4 ; b++){ farray[b] = 0.0f; }
+    for ( int cy=1; cy<ncycle ; cy++){
+        for ( int b=0 ; b<NBASE ; b++){
+            farray[4*cy+b] = HUGE_VALF;
+            for ( int prev=0 ; prev<4 ; prev++){
+                float callLS = basecost[4*(cy-1)+prev] + farray[4*(cy-1)+prev] + 2.0f*crosscost[16*cy+4*prev+b];
+                if(callLS<farray[4*cy+b]){ farray[4*cy+b] = callLS; }
+            }
+        }
+    }
+
+    // Backwards piece of algorithm.
+    for ( int b=0 ; b<4 ; b++){ barray[(ncycle-1)*4+b] = 0.0f; }
+    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
+        for ( int b=0 ; b<NBASE ; b++){
+            barray[4*cy+b] = HUGE_VALF;
+            for ( int nxt=0 ; nxt<4 ; nxt++){
+                float callLS = basecost[4*(cy+1)+nxt] + barray[4*(cy+1)+nxt] + 2.0f*crosscost[16*(cy+1)+4*b+nxt];
+                if(callLS<barray[4*cy+b]){ barray[4*cy+b] = callLS; }
+            }
+        }
+    }
+
+    real_t stat[4*ncycle];
+    for ( int i=0 ; i<4*ncycle ; i++){
+        stat[i] = (real_t)farray[i] + (real_t)barray[i] + (real_t)basecost[i];
+        stat[i] *= lambda;
+        stat[i] += pOp;
+    }
+    posterior_qualities(stat, ncycle, base, effDF, qual);
+}
+
 
 /* public functions */
 
@@ -170,6 +561,35 @@ struct basequal call_base( const real_t * restrict p, const real_t lambda, const
     return b;
 }
 
+/**
+ * Create a double precision copy of the tridiagonal band of omega, once per iteration.
+ * For each cycle holds the NBASE x NBASE diagonal block followed by the block linking the cycle
+ * to the next, both laid out as in omega. The link block of the last cycle is zero.
+ * Returns NULL if memory allocation fails. Free with xfree.
+ */
+real_t * new_omega_table(const MAT omega){
+    if (NULL==omega) { return NULL; }
+
+    const int lda = omega->ncol;
+    const int ncycle = lda / NBASE;
+    real_t * table = calloc(ncycle * OMBAND, sizeof(real_t));
+    if (NULL==table) { return NULL; }
+
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const real_t * diag = omega->x + cy*NBASE*lda + cy*NBASE;
+        const real_t * cross = omega->x + cy*NBASE*lda + (cy+1)*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            for ( int b=0 ; b<NBASE ; b++){
+                table[cy*OMBAND + a*NBASE + b] = diag[a*lda+b];
+                if (cy<ncycle-1) {
+                    table[cy*OMBAND + NBASE*NBASE + a*NBASE + b] = cross[a*lda+b];
+                }
+            }
+        }
+    }
+    return table;
+}
+
 /**
  * Call bases from processed intensities.
  * Uses a dynamic programming algorithm (Viterbi) to find the bases that minimise the
@@ -186,178 +606,201 @@ struct basequal call_base( const real_t * restrict p, const real_t lambda, const
         Om_{21} Om_{22}   Om_{32}^t
         0       Om_{32}   Om_{33}
 \endverbatim
+ * The products of the intensities with the blocks of omega are formed once, so the cost of each
+ * base and pair of bases is a few operations on precomputed values.
+ * - omtab:    Omega band table from new_omega_table
+ *
  * Return value is p^t Om p + lambda * min A.
  */  
-real_t call_bases( const MAT p, const real_t lambda, const MAT omega, NUC * base){
-    if (NULL==base || NULL==p || NULL==omega) { return NAN; }
+HOT_KERNEL real_t call_bases( const MAT p, const real_t lambda, const real_t * omtab, NUC * base){
+    if (NULL==base || NULL==p || NULL==omtab) { return NAN; }
 
     const int ncycle = p->ncol;
-    const int lda = omega->ncol;
-
-    // array contains accumulation information and trace-back directions
-    real_t array[NBASE*ncycle];
-    // Initialise. First elements of array contain contribution from first cycle.
-    for ( int b=0 ; b<NBASE ; b++){
-        array[b] = baselike(p->x,lambda,b,omega->x,ncycle);
-    }
-
-    // Forwards piece of algorithm. For each cycle, for each base, find the base in the
-    // previous cycle that minimises
-    for ( int cy=1; cy<ncycle ; cy++){
-        NUC precall[NBASE];
-        for ( int b=0 ; b<NBASE ; b++){
-            // Contribution from calling b at cycle cy, independent from other cycles
-            real_t diag = baselike(p->x+cy*NBASE,lambda,b,omega->x+cy*NBASE*lda+cy*NBASE,ncycle);
-            // Find call prev at previous cycle that minimises cost of calling b and prev
-            real_t minstat = HUGE_VAL;
-            int minidx = 0;
-            real_t stat[NBASE];
-            for ( int prev=0 ; prev<NBASE ; prev++){
-                stat[prev] = diag +                     // Cost of calling b at cycle cy
-                        array[(cy-1)*NBASE+prev] +      // Cost of calling prev at cycle (cy-1)
-                        // Adjustment for calling both.
-                        2.0*crosslike(p->x+(cy-1)*NBASE,lambda,prev,b,omega->x+(cy-1)*NBASE*lda+cy*NBASE,ncycle);
-                // Keep track of best previous call
-                if(stat[prev]<minstat){
-                    minidx = prev;
-                    minstat = stat[prev];
-                }
-            }
-            // Save best call for previous cycle given call b at this cycle.
-            array[cy*NBASE+b] = minstat;
-            precall[b] = minidx;
-        }
-        // No longer need previous entries of array. Use memory to save trace-back
-        // information.
-        for ( int b=0 ; b<NBASE ; b++){
-            array[(cy-1)*NBASE+b] = precall[b];
-        }
-    }
-
-    // Backwards piece of algorithm.
-    // Find best call on last cycle
-    real_t minstat = HUGE_VAL;
-    int minidx = 0;
-    for ( int b=0 ; b<NBASE ; b++){
-        if(array[(ncycle-1)*NBASE+b]<minstat){ minidx = b; minstat = array[(ncycle-1)*NBASE+b];}
-    }
-    // Trace calls backward using previously stored information
-    base[ncycle-1] = minidx;
-    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
-        base[cy] = (NUC)array[cy*NBASE+base[cy+1]];
-    }
+    real_t proj[NPROJ*ncycle];
+    real_t basecost[4*ncycle], crosscost[16*ncycle];
+    const real_t pOp = project_intensities(p->x, ncycle, omtab, proj);
+    fill_costs(proj, ncycle, lambda, omtab, basecost, crosscost);
 
-    return xOx(p->x,1,NBASE,omega) + lambda * minstat;
+    return pOp + lambda * viterbi_costs(basecost, crosscost, ncycle, base);
 }
 
 /** 
  * Calculate the call_bases return value for a supplied sequence. 
  * See call_bases for algorithm. 
  */
-real_t calculate_lss(const MAT p, const real_t lambda, const MAT omega, const NUC * base) {
-    if (NULL==base || NULL==p || NULL==omega) { return NAN; }
+HOT_KERNEL real_t calculate_lss(const MAT p, const real_t lambda, const real_t * omtab, const NUC * base) {
+    if (NULL==base || NULL==p || NULL==omtab) { return NAN; }
 
     const int ncycle = p->ncol;
-    const int lda = omega->ncol;
+    real_t proj[NPROJ*ncycle];
+    real_t basecost[4*ncycle], crosscost[16*ncycle];
+    const real_t pOp = project_intensities(p->x, ncycle, omtab, proj);
+    fill_costs(proj, ncycle, lambda, omtab, basecost, crosscost);
 
-	real_t res = 0.0;
+    real_t res = 0.0;
     for ( int cy=0; cy<ncycle ; cy++){
-		res += baselike(p->x+cy*NBASE,lambda,base[cy],omega->x+cy*NBASE*lda+cy*NBASE,ncycle);
-	}
+        res += basecost[4*cy+base[cy]];
+    }
     for ( int cy=1; cy<ncycle ; cy++){
-		res += 2.0*crosslike(p->x+(cy-1)*NBASE,lambda,base[cy-1],base[cy],omega->x+(cy-1)*NBASE*lda+cy*NBASE,ncycle);
-	}
-	
-	return xOx(p->x,1,NBASE,omega) + lambda * res;
+        res += 2.0*crosscost[16*cy+4*base[cy-1]+base[cy]];
+    }
+
+    return pOp + lambda * res;
 }
 
 /** 
  * Posterior probabilities via fwds/bwds.
- * Repeats much of call_bases.
+ * On the final iteration call_bases_qualities calls bases and qualities from one set of costs.
  */
-void call_qualities_post(const MAT p, const real_t lambda, const MAT omega, const real_t effDF, NUC * base, real_t * qual){
-	if(NULL==base || NULL==p || NULL==omega){ return; }
+HOT_KERNEL void call_qualities_post(const MAT p, const real_t lambda, const real_t * omtab, const real_t effDF, NUC * base, real_t * qual){
+	if(NULL==base || NULL==p || NULL==omtab){ return; }
 
     const int ncycle = p->ncol;
-    const int lda = omega->ncol;
-    const real_t polyErr = -expm1(-PolyQual/10.0 * log(10.0));
+    real_t proj[NPROJ*ncycle];
+    real_t basecost[4*ncycle], crosscost[16*ncycle];
+    const real_t pOp = project_intensities(p->x, ncycle, omtab, proj);
+    fill_costs(proj, ncycle, lambda, omtab, basecost, crosscost);
+    qualities_costs(basecost, crosscost, ncycle, lambda, pOp, effDF, base, qual);
+}
 
-    // arrays contain accumulation information
-    real_t farray[4*ncycle], barray[4*ncycle];
-    // Calculate costs
+/**
+ * Call bases and their posterior qualities together, for the final iteration.
+ * The cost arrays are calculated once and shared by the Viterbi algorithm of call_bases
+ * and the fwds/bwds of call_qualities_post; bases, qualities and the return value
+ * are identical to calling the two separately.
+ */
+HOT_KERNEL real_t call_bases_qualities(const MAT p, const real_t lambda, const real_t * omtab, const real_t effDF, NUC * base, real_t * qual){
+    if (NULL==base || NULL==p || NULL==omtab || NULL==qual) { return NAN; }
+
+    const int ncycle = p->ncol;
+    real_t proj[NPROJ*ncycle];
     real_t basecost[4*ncycle], crosscost[16*ncycle];
-    for ( int b=0 ; b<NBASE ; b++){
-        basecost[b] = baselike(p->x,lambda,b,omega->x,ncycle);
-    }
-    for ( int cy=1 ; cy<ncycle ; cy++){
-        for ( int b=0 ; b<NBASE ; b++){
-            basecost[4*cy+b] = baselike(p->x+cy*NBASE,lambda,b,omega->x+cy*NBASE*lda+cy*NBASE,ncycle);
-            for ( int b2=0 ; b2<NBASE ; b2++){
-                crosscost[16*cy+4*b+b2] = crosslike(p->x+(cy-1)*NBASE,lambda,b,b2,omega->x+(cy-1)*NBASE*lda+cy*NBASE,ncycle);
-            }
-        }
-    }
+    const real_t pOp = project_intensities(p->x, ncycle, omtab, proj);
+    fill_costs(proj, ncycle, lambda, omtab, basecost, crosscost);
 
-    // Forwards piece of algorithm.
-    // Initalise
-    for ( int b=0 ; b<4 ; b++){ farray[b] = 0.0; }
-    // Iteration
-    for ( int cy=1; cy<ncycle ; cy++){
-        for ( int b=0 ; b<NBASE ; b++){
-            farray[4*cy+b] = HUGE_VAL;
-            // Find minimum for past calls give current call
-            for ( int prev=0 ; prev<4 ; prev++){
-                real_t callLS = basecost[4*(cy-1)+prev] + farray[4*(cy-1)+prev] + 2.0*crosscost[16*cy+4*prev+b];
-                if(callLS<farray[4*cy+b]){ farray[4*cy+b] = callLS; }
+    const real_t minstat = viterbi_costs(basecost, crosscost, ncycle, base);
+    qualities_costs(basecost, crosscost, ncycle, lambda, pOp, effDF, base, qual);
+
+    return pOp + lambda * minstat;
+}
+
+/**
+ * Create a single precision copy of the tridiagonal band of omega for mixed precision calling.
+ * Laid out as new_omega_table.
+ * Returns NULL if memory allocation fails. Free with xfree.
+ */
+float * new_omega_band(const MAT omega){
+    if (NULL==omega) { return NULL; }
+
+    const int lda = omega->ncol;
+    const int ncycle = lda / NBASE;
+    float * band = calloc(ncycle * OMBAND, sizeof(float));
+    if (NULL==band) { return NULL; }
+
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const real_t * diag = omega->x + cy*NBASE*lda + cy*NBASE;
+        const real_t * cross = omega->x + cy*NBASE*lda + (cy+1)*NBASE;
+        for ( int a=0 ; a<NBASE ; a++){
+            for ( int b=0 ; b<NBASE ; b++){
+                band[cy*OMBAND + a*NBASE + b] = (float)diag[a*lda+b];
+                if (cy<ncycle-1) {
+                    band[cy*OMBAND + NBASE*NBASE + a*NBASE + b] = (float)cross[a*lda+b];
+                }
             }
         }
     }
-    real_t fwdslike = HUGE_VAL;
-    for ( int b=0 ; b<4 ; b++){
-        if(basecost[(ncycle-1)*4+b]+farray[(ncycle-1)*4+b]<fwdslike){
-            fwdslike = basecost[(ncycle-1)*4+b]+farray[(ncycle-1)*4+b];
-        }
-    }
+    return band;
+}
 
-    // Backwards piece of algorithm.
-    // Initialise
-    for ( int b=0 ; b<4 ; b++){ barray[(ncycle-1)*4+b] = 0.0; }
-    // Iteration
-    for ( int cy=(ncycle-2) ; cy>=0 ; cy--){
-        for ( int b=0 ; b<NBASE ; b++){
-            barray[4*cy+b] = HUGE_VAL;
-            // Find minimum for future calls given current call
-            for ( int nxt=0 ; nxt<4 ; nxt++){
-                real_t callLS = basecost[4*(cy+1)+nxt] + barray[4*(cy+1)+nxt] + 2.0*crosscost[16*(cy+1)+4*b+nxt];
-                if(callLS<barray[4*cy+b]){ barray[4*cy+b] = callLS; }
-            }
-        }
+/**
+ * Mixed precision version of call_bases.
+ * Processed intensities, omega and the dynamic programming array are single precision;
+ * the quadratic form p^t Om p and the returned residual are accumulated in double.
+ * - omband:   Single precision omega band from new_omega_band
+ */
+HOT_KERNEL real_t call_bases_mixed( const MAT p, const real_t lambda, const MAT omega, const float * omband, NUC * base){
+    if (NULL==base || NULL==p || NULL==omega || NULL==omband) { return NAN; }
+
+    const int ncycle = p->ncol;
+    float pf[NBASE*ncycle];
+    float_from_MAT(p, pf);
+
+    float proj[NPROJ*ncycle];
+    float basecost[4*ncycle], crosscost[16*ncycle];
+    project_intensities_f(pf, ncycle, omband, proj);
+    fill_costs_f(proj, ncycle, (float)lambda, omband, basecost, crosscost);
+
+    const float minstat = viterbi_costs_f(basecost, crosscost, ncycle, base);
+    return xOx(p->x,1,NBASE,omega) + lambda * (real_t)minstat;
+}
+
+/**
+ * Mixed precision version of calculate_lss.
+ * Individual terms are single precision, their sum is accumulated in double.
+ */
+HOT_KERNEL real_t calculate_lss_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const NUC * base) {
+    if (NULL==base || NULL==p || NULL==omega || NULL==omband) { return NAN; }
+
+    const int ncycle = p->ncol;
+    float pf[NBASE*ncycle];
+    float_from_MAT(p, pf);
+
+    float proj[NPROJ*ncycle];
+    float basecost[4*ncycle], crosscost[16*ncycle];
+    project_intensities_f(pf, ncycle, omband, proj);
+    fill_costs_f(proj, ncycle, (float)lambda, omband, basecost, crosscost);
+
+    real_t res = 0.0;
+    for ( int cy=0; cy<ncycle ; cy++){
+        res += basecost[4*cy+base[cy]];
     }
-    real_t bkdslike = HUGE_VAL;
-    for ( int b=0 ; b<4 ; b++){
-        if(basecost[b]+barray[b]<bkdslike){
-            bkdslike = basecost[b]+barray[b];
-        }
+    for ( int cy=1; cy<ncycle ; cy++){
+        res += 2.0*crosscost[16*cy+4*base[cy-1]+base[cy]];
     }
-	//fprintf(stdout,"%e %e\n",fwdslike,bkdslike);
 
-    real_t pOp = xOx(p->x,1,NBASE,omega);
-    //fprintf(stdout,"%e\n",pOp+lambda*(farray[base[0]] + barray[base[0]] + basecost[base[0]]));
-    for ( int cy=0 ; cy<ncycle ; cy++){
-        int b = base[cy];
-        real_t xmax = farray[4*cy+b] + barray[4*cy+b] + basecost[4*cy+b];
-        xmax = pOp + lambda * xmax;
-        real_t sum = 0.0;
-        for ( int b=0 ; b<4 ; b++){
-            real_t stat = farray[4*cy+b] + barray[4*cy+b] + basecost[4*cy+b];
-            stat *= lambda;
-            stat += pOp;
-            sum += exp(-0.5*(1.0+effDF)*(log1p(stat)-log1p(xmax)));
-        }
-        real_t prob = 1.0 / sum;
-        prob *= polyErr;
-        qual[cy] = quality_from_prob(prob);
-    }
+    return xOx(p->x,1,NBASE,omega) + lambda * res;
+}
+
+/**
+ * Mixed precision version of call_qualities_post.
+ * Cost arrays and the fwds/bwds recursions are single precision; the per-base
+ * statistics and the posterior probability sums are formed in double.
+ */
+HOT_KERNEL void call_qualities_post_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const real_t effDF, NUC * base, real_t * qual){
+    if(NULL==base || NULL==p || NULL==omega || NULL==omband){ return; }
+
+    const int ncycle = p->ncol;
+    float pf[NBASE*ncycle];
+    float_from_MAT(p, pf);
+
+    float proj[NPROJ*ncycle];
+    float basecost[4*ncycle], crosscost[16*ncycle];
+    project_intensities_f(pf, ncycle, omband, proj);
+    fill_costs_f(proj, ncycle, (float)lambda, omband, basecost, crosscost);
+    qualities_costs_f(basecost, crosscost, ncycle, lambda, xOx(p->x,1,NBASE,omega), effDF, base, qual);
+}
+
+/**
+ * Mixed precision version of call_bases_qualities.
+ * Identical to calling call_bases_mixed and call_qualities_post_mixed separately.
+ */
+HOT_KERNEL real_t call_bases_qualities_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const real_t effDF, NUC * base, real_t * qual){
+    if (NULL==base || NULL==p || NULL==omega || NULL==omband || NULL==qual) { return NAN; }
+
+    const int ncycle = p->ncol;
+    float pf[NBASE*ncycle];
+    float_from_MAT(p, pf);
+
+    float proj[NPROJ*ncycle];
+    float basecost[4*ncycle], crosscost[16*ncycle];
+    project_intensities_f(pf, ncycle, omband, proj);
+    fill_costs_f(proj, ncycle, (float)lambda, omband, basecost, crosscost);
+
+    const float minstat = viterbi_costs_f(basecost, crosscost, ncycle, base);
+    const real_t pOp = xOx(p->x,1,NBASE,omega);
+    qualities_costs_f(basecost, crosscost, ncycle, lambda, pOp, effDF, base, qual);
+
+    return pOp + lambda * (real_t)minstat;
 }
 
 /** Return value of generalised error. */
@@ -388,3 +831,105 @@ bool set_mu(const char *mu_str) {
     return (Mu > 0);
 }
 
+
+#ifdef TEST
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int NGRID = 200001;                ///< Points in each test grid.
+static const int64_t MAX_ULP = 2;               ///< Allowed difference from libm in ulp.
+static const real_t MAX_QUAL = 1e-6;            ///< Allowed difference in quality value.
+
+/** Distance in ulp between two doubles, zero if both NaN or equal infinities. */
+static int64_t ulp_distance(const real_t a, const real_t b){
+    if (isnan(a) || isnan(b)) { return (isnan(a) && isnan(b)) ? 0 : INT64_MAX; }
+    if (a == b) { return 0; }
+    if (isinf(a) || isinf(b) || (signbit(a) != signbit(b))) { return INT64_MAX; }
+    int64_t ia, ib;
+    memcpy(&ia, &a, sizeof(a));
+    memcpy(&ib, &b, sizeof(b));
+    return (ia > ib) ? ia - ib : ib - ia;
+}
+
+/** Qualities as calculated before the polynomial exp and log were introduced. */
+static void posterior_qualities_libm(const real_t * stat, const int ncycle, const NUC * base, const real_t effDF, real_t * qual){
+    const real_t polyErr = -expm1(-PolyQual/10.0 * log(10.0));
+    for ( int cy=0 ; cy<ncycle ; cy++){
+        const real_t xmax = stat[4*cy+base[cy]];
+        real_t sum = 0.0;
+        for ( int b=0 ; b<4 ; b++){
+            sum += exp(-0.5*(1.0+effDF)*(log1p(stat[4*cy+b])-log1p(xmax)));
+        }
+        qual[cy] = quality_from_prob(polyErr / sum);
+    }
+}
+
+int main(void){
+    real_t *x = calloc(NGRID, sizeof(*x));
+    real_t *y = calloc(NGRID, sizeof(*y));
+    if ((NULL == x) || (NULL == y)) { return EXIT_FAILURE; }
+
+    fputs("* Polynomial exp against libm, x in [-750, 720] and special values.\n", stdout);
+    for ( int i=0 ; i<NGRID ; i++){
+        x[i] = -750.0 + 1470.0 * i / (NGRID - 1);
+    }
+    x[0] = NAN; x[1] = INFINITY; x[2] = -INFINITY;
+    exp_array(x, NGRID, y);
+    int64_t maxulp = 0;
+    for ( int i=0 ; i<NGRID ; i++){
+        const int64_t d = ulp_distance(y[i], exp(x[i]));
+        if (d > maxulp) { maxulp = d; }
+    }
+    fprintf(stdout, "Within %d ulp: %s\n", (int)MAX_ULP, (maxulp <= MAX_ULP) ? "pass" : "fail");
+
+    fputs("* Polynomial log1p against libm, x in (-1, 1e6] and special values.\n", stdout);
+    for ( int i=0 ; i<NGRID ; i++){
+        x[i] = -1.0 + pow(10.0, -15.0 + 21.0 * i / (NGRID - 1));
+    }
+    x[0] = NAN; x[1] = INFINITY; x[2] = -1.0; x[3] = -2.0; x[4] = 0.0; x[5] = 1e-300;
+    log1p_array(x, NGRID, y);
+    // besides its own error, log1p_array inherits the rounding of 1+x, at most DBL_EPSILON/2 in the result
+    bool ok = true;
+    for ( int i=0 ; i<NGRID ; i++){
+        const real_t ref = log1p(x[i]);
+        if (isfinite(ref) && (x[i] != 0.0)) {
+            const real_t ulp = nextafter(fabs(ref), INFINITY) - fabs(ref);
+            ok &= (fabs(y[i] - ref) <= MAX_ULP * ulp + DBL_EPSILON / 2.0);
+        }
+        else {
+            ok &= (ulp_distance(y[i], ref) == 0);
+        }
+    }
+    fprintf(stdout, "Within %d ulp and rounding of 1+x: %s\n", (int)MAX_ULP, ok ? "pass" : "fail");
+
+    fputs("* Posterior qualities against libm calculation.\n", stdout);
+    const int ncycle = 100;
+    const int nrep = 1000;
+    real_t stat[4*ncycle], qual[ncycle], qref[ncycle];
+    NUC base[ncycle];
+    real_t maxqual = 0.0;
+    srand(1);
+    for ( int rep=0 ; rep<nrep ; rep++){
+        // called base has the smallest statistic, others spread over orders of magnitude
+        const real_t effDF = 1.0 + 50.0 * rand() / RAND_MAX;
+        for ( int cy=0 ; cy<ncycle ; cy++){
+            base[cy] = rand() % NBASE;
+            const real_t smin = pow(10.0, -2.0 + 6.0 * rand() / RAND_MAX);
+            for ( int b=0 ; b<4 ; b++){
+                stat[4*cy+b] = (b == base[cy]) ? smin : smin * (1.0 + pow(10.0, -4.0 + 6.0 * rand() / RAND_MAX));
+            }
+        }
+        posterior_qualities(stat, ncycle, base, effDF, qual);
+        posterior_qualities_libm(stat, ncycle, base, effDF, qref);
+        for ( int cy=0 ; cy<ncycle ; cy++){
+            const real_t d = fabs(qual[cy] - qref[cy]);
+            if (!(d <= maxqual)) { maxqual = d; }
+        }
+    }
+    fprintf(stdout, "Qualities of %d reads within %.1e: %s\n", nrep, MAX_QUAL, (maxqual <= MAX_QUAL) ? "pass" : "fail");
+
+    free(x);
+    free(y);
+    return EXIT_SUCCESS;
+}
+#endif
@@ -38,9 +38,16 @@ NUC call_base_simple( const real_t * restrict p);
 NUC call_base_nodata(void);
 struct basequal call_base_null(void);
 struct basequal call_base( const real_t * restrict p, const real_t lambda, const real_t * restrict penalty, const MAT omega);
-real_t call_bases( const MAT p, const real_t lambda, const MAT omega, NUC * base);
-real_t calculate_lss(const MAT p, const real_t lambda, const MAT omega, const NUC * base);
-void call_qualities_post(const MAT p, const real_t lambda, const MAT omega, const real_t effDF, NUC * base, real_t * qual);
+real_t * new_omega_table(const MAT omega);
+real_t call_bases( const MAT p, const real_t lambda, const real_t * omtab, NUC * base);
+real_t calculate_lss(const MAT p, const real_t lambda, const real_t * omtab, const NUC * base);
+void call_qualities_post(const MAT p, const real_t lambda, const real_t * omtab, const real_t effDF, NUC * base, real_t * qual);
+real_t call_bases_qualities(const MAT p, const real_t lambda, const real_t * omtab, const real_t effDF, NUC * base, real_t * qual);
+float * new_omega_band(const MAT omega);
+real_t call_bases_mixed( const MAT p, const real_t lambda, const MAT omega, const float * omband, NUC * base);
+real_t calculate_lss_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const NUC * base);
+void call_qualities_post_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const real_t effDF, NUC * base, real_t * qual);
+real_t call_bases_qualities_mixed(const MAT p, const real_t lambda, const MAT omega, const float * omband, const real_t effDF, NUC * base, real_t * qual);
 
 real_t get_generr(void);
 bool set_generr(const char *generr_str);
@@ -80,6 +80,19 @@ static real_t round_and_clip(real_t x, const int32_t min, const int32_t max) {
     return x;
 }
 
+/**
+ * Index of a channel value in the intensities, ordered by cycle, channel then cluster.
+ * Calculated in size_t since a large tile has more than 2^32 values.
+ */
+static inline size_t cif_index(const CIFDATA cif, const uint32_t cl, const uint32_t base, const uint32_t cy) {
+    return ((size_t)cy * NCHANNEL + base) * cif->ncluster + cl;
+}
+
+/** Number of channel values in ncycle cycles of ncluster clusters. */
+static inline size_t cif_nvalue(const uint32_t ncycle, const uint32_t ncluster) {
+    return (size_t)NCHANNEL * ncycle * ncluster;
+}
+
 
 /* public functions */
 /* undetermined */
@@ -100,9 +113,9 @@ long int cif_get_int (const CIFDATA cif, const uint32_t cl, const uint32_t base,
     if ((cl >= cif->ncluster) || (base >= NCHANNEL)|| (cy >= cif->ncycle) ) {return 0;}
 
     switch(cif->datasize) {
-        case 1: return cif->intensity.i8 [(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
-        case 2: return cif->intensity.i16[(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
-        case 4: return cif->intensity.i32[(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
+        case 1: return cif->intensity.i8 [cif_index(cif, cl, base, cy)]; break;
+        case 2: return cif->intensity.i16[cif_index(cif, cl, base, cy)]; break;
+        case 4: return cif->intensity.i32[cif_index(cif, cl, base, cy)]; break;
         default: return 0;
     }
 }
@@ -115,9 +128,9 @@ real_t cif_get_real (const CIFDATA cif, const uint32_t cl, const uint32_t base,
     if ((cl >= cif->ncluster) || (base >= NCHANNEL)|| (cy >= cif->ncycle) ) {return NAN;}
 
     switch(cif->datasize) {
-        case 1: return (real_t)cif->intensity.i8 [(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
-        case 2: return (real_t)cif->intensity.i16[(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
-        case 4: return (real_t)cif->intensity.i32[(cy * NCHANNEL + base) * cif->ncluster + cl]; break;
+        case 1: return (real_t)cif->intensity.i8 [cif_index(cif, cl, base, cy)]; break;
+        case 2: return (real_t)cif->intensity.i16[cif_index(cif, cl, base, cy)]; break;
+        case 4: return (real_t)cif->intensity.i32[cif_index(cif, cl, base, cy)]; break;
         default: return NAN;
     }
 }
@@ -128,22 +141,22 @@ void cif_set_from_real (CIFDATA cif, const uint32_t cl, const uint32_t base, con
     if (NULL==cif) {return;}
     if ((cl >= cif->ncluster) || (base >= NCHANNEL)|| (cy >= cif->ncycle) ) {return;}
     if (NULL==cif->intensity.i8) {
-        cif->intensity.i8 = calloc(cif->ncycle * cif->ncluster * NCHANNEL, cif->datasize);
+        cif->intensity.i8 = calloc(cif_nvalue(cif->ncycle, cif->ncluster), cif->datasize);
         if (NULL==cif->intensity.i8) {return;}
     }
 
     switch(cif->datasize) {
         case 1:
             x = round_and_clip(x, INT8_MIN, INT8_MAX);
-            cif->intensity.i8[(cy * NCHANNEL + base) * cif->ncluster + cl] = (int8_t)x;
+            cif->intensity.i8[cif_index(cif, cl, base, cy)] = (int8_t)x;
             break;
         case 2:
             x = round_and_clip(x, INT16_MIN, INT16_MAX);
-            cif->intensity.i16[(cy * NCHANNEL + base) * cif->ncluster + cl] = (int16_t)x;
+            cif->intensity.i16[cif_index(cif, cl, base, cy)] = (int16_t)x;
             break;
         case 4:
             x = round_and_clip(x, INT32_MIN, INT32_MAX);
-            cif->intensity.i32[(cy * NCHANNEL + base) * cif->ncluster + cl] = (int32_t)x;
+            cif->intensity.i32[cif_index(cif, cl, base, cy)] = (int32_t)x;
             break;
         default: ;
     }
@@ -180,11 +193,11 @@ void free_cif ( CIFDATA cif ){
 bool __attribute__((const)) isCifAllowedDatasize ( const uint8_t datasize );
 CIFDATA readCifHeader (XFILE * ayb_fp);
 encInt readCifIntensities ( XFILE * ayb_fp , const CIFDATA header, encInt intensties );
-encInt readEncodedFloats ( XFILE  * ayb_fp, const uint32_t nfloat, const uint8_t nbyte, encInt  tmp_mem );
+encInt readEncodedFloats ( XFILE  * ayb_fp, const size_t nfloat, const uint8_t nbyte, encInt  tmp_mem );
 bool writeCifHeader ( XFILE * ayb_fp, const CIFDATA header);
 bool writeCifIntensities ( XFILE * ayb_fp , const CIFDATA header,
                            const encInt intensities );
-bool writeEncodedFloats ( XFILE * ayb_fp , const uint32_t nfloat , const uint8_t nbyte,
+bool writeEncodedFloats ( XFILE * ayb_fp , const size_t nfloat , const uint8_t nbyte,
                           const encInt floats );
 
 
@@ -248,22 +261,32 @@ CIFDATA readCifHeader (XFILE * ayb_fp){
     return header;
 }
 
-/* Read intensities */
+/* Read intensities; null if the file holds fewer than the header describes */
 encInt readCifIntensities ( XFILE * ayb_fp , const CIFDATA header, encInt  intensities ){
-    const uint32_t size = NCHANNEL * header->ncluster * header->ncycle;
+    const size_t size = cif_nvalue(header->ncycle, header->ncluster);
     intensities = readEncodedFloats(ayb_fp,size,header->datasize,intensities);
     return intensities;
 }
 
-/* Read an array of encoded floats and return array */
-encInt readEncodedFloats ( XFILE  * ayb_fp, const uint32_t nfloat, const uint8_t nbyte, encInt intensities ){
+/*  Read an array of encoded floats and return array
+ *  Returns null if the memory could not be allocated or fewer than nfloat were read,
+ * freeing the array only if allocated here.
+ */
+encInt readEncodedFloats ( XFILE  * ayb_fp, const size_t nfloat, const uint8_t nbyte, encInt intensities ){
     assert(1==nbyte || 2==nbyte || 4==nbyte);
     assert(nfloat>0);
 
-    if ( NULL==intensities.i32 ){
+    const bool allocated = (NULL==intensities.i32);
+    if ( allocated ){
         intensities.i8 = calloc(nfloat,nbyte);
+        if ( NULL==intensities.i8 ){ return intensities;}
+    }
+    /* read in bytes, which xfread counts for every file mode */
+    const size_t nbytes = nfloat * nbyte;
+    if ( xfread(intensities.i8,1,nbytes,ayb_fp)!=nbytes ){
+        if ( allocated ){ free(intensities.i8);}
+        intensities.i8 = NULL;
     }
-    xfread(intensities.i8,nbyte,nfloat,ayb_fp);
 
     return intensities;
 }
@@ -290,7 +313,7 @@ bool writeCifHeader ( XFILE * ayb_fp, const CIFDATA header){
  */
 bool writeCifIntensities ( XFILE * ayb_fp , const CIFDATA  header,
                            const encInt  intensities ){
-    const uint32_t nfloat = NCHANNEL * header->ncycle * header->ncluster;
+    const size_t nfloat = cif_nvalue(header->ncycle, header->ncluster);
     return writeEncodedFloats ( ayb_fp, nfloat, header->datasize, intensities );
 }
 
@@ -368,7 +391,7 @@ int32_t __attribute__((const)) getMin (const uint8_t nbyte){
 
 /*  Write floats in encoded format
  */
-bool writeEncodedFloats ( XFILE * ayb_fp , const uint32_t nfloat , const uint8_t nbyte,
+bool writeEncodedFloats ( XFILE * ayb_fp , const size_t nfloat , const uint8_t nbyte,
                           const encInt  intensities ){
     xfwrite( intensities.i8, nbyte, nfloat, ayb_fp);
     return true;
@@ -385,7 +408,7 @@ bool write2CIFstream ( XFILE * ayb_fp, const encInt  intensities, const uint16_t
 
     struct cifData header = { 1, nbyte, firstcycle, ncycle, ncluster, {.i8=NULL} };
     writeCifHeader(ayb_fp,&header);
-    writeEncodedFloats(ayb_fp,ncluster*ncycle*NCHANNEL,nbyte,intensities);
+    writeEncodedFloats(ayb_fp,cif_nvalue(ncycle,ncluster),nbyte,intensities);
 
     return true;
 }
@@ -420,9 +443,61 @@ CIFDATA readCIFfromStream ( XFILE * ayb_fp ){
     if (NULL==cif) {return NULL;}
     encInt e = {.i8=NULL};
     cif->intensity = readCifIntensities ( ayb_fp , cif, e );
+    if (NULL==cif->intensity.i8) {
+        /* incomplete file */
+        free_cif(cif);
+        return NULL;
+    }
     return cif;
 }
 
+/*  Read only the cycles flagged in use, which has nuse elements.
+ *  The cycles kept are stored consecutively and cif->ncycle is the number kept.
+ * Ignored cycles before the last one wanted are read into a single cycle of
+ * scratch, since the stream may not be seekable, and later cycles are not read.
+ */
+CIFDATA readCIFcyclesfromStream ( XFILE * ayb_fp, const bool * use, const uint32_t nuse ){
+    if(NULL==use){ return readCIFfromStream(ayb_fp);}
+    if(NULL==ayb_fp){ return NULL;}
+    CIFDATA cif = readCifHeader(ayb_fp);
+    if (NULL==cif) {return NULL;}
+
+    const uint32_t nread = (cif->ncycle<nuse)?cif->ncycle:nuse;
+    const size_t cyclesize = cif_nvalue(1,cif->ncluster);
+    /* read in bytes, which xfread counts for every file mode */
+    const size_t cyclebytes = cyclesize * cif->datasize;
+    uint32_t nkeep = 0, last = 0;
+    for ( uint32_t cy=0 ; cy<nread ; cy++){
+        if(use[cy]){ nkeep++; last = cy+1; }
+    }
+
+    int8_t * scratch = NULL;
+    cif->ncycle = nkeep;
+    if(0==nkeep){ return cif;}
+    cif->intensity.i8 = calloc(nkeep*cyclesize,cif->datasize);
+    if(NULL==cif->intensity.i8){ goto readcycles_error;}
+
+    int8_t * dest = cif->intensity.i8;
+    for ( uint32_t cy=0 ; cy<last ; cy++){
+        if(use[cy]){
+            if(xfread(dest,1,cyclebytes,ayb_fp)!=cyclebytes){ goto readcycles_error;}
+            dest += cyclebytes;
+        }
+        else {
+            if(NULL==scratch){ scratch = malloc(cyclebytes);}
+            if(NULL==scratch){ goto readcycles_error;}
+            if(xfread(scratch,1,cyclebytes,ayb_fp)!=cyclebytes){ goto readcycles_error;}
+        }
+    }
+    free(scratch);
+    return cif;
+
+readcycles_error:
+    free(scratch);
+    free_cif(cif);
+    return NULL;
+}
+
 CIFDATA readCIFfromFile ( const char * fn, const XFILE_MODE mode){
     XFILE * ayb_fp = xfopen(fn,mode,"rb");
     if ( NULL==ayb_fp){ return NULL;}
@@ -438,10 +513,12 @@ bool consistent_cif_headers( const CIFDATA cif1, const CIFDATA cif2 ){
    return true;
 }
 
-CIFDATA cif_add_file( const char * fn, const XFILE_MODE mode, CIFDATA cif ){
+/*  Add the data in a single cycle CIF file to the cycle at index cycle of cif.
+ *  Memory for all cif->ncycle cycles is allocated when the first file is read.
+ */
+CIFDATA cif_add_file( const char * fn, const XFILE_MODE mode, CIFDATA cif, const uint32_t cycle ){
    XFILE * ayb_fp = NULL;
    CIFDATA newheader = NULL;
-   encInt mem = {.i32=NULL};
 
    if ( NULL==fn){ goto cif_add_error;}
    ayb_fp = xfopen(fn,mode,"rb");
@@ -451,19 +528,16 @@ CIFDATA cif_add_file( const char * fn, const XFILE_MODE mode, CIFDATA cif ){
    if ( NULL==newheader ){ goto cif_add_error;}
    if ( NULL==cif->intensity.i8 ){
       cif->ncluster = newheader->ncluster;
+      cif->datasize = newheader->datasize;
       // First file read. Allocated memory needed
-      cif->intensity.i8 = calloc(cif->ncycle*cif->ncluster*NCHANNEL,cif->datasize);
+      cif->intensity.i8 = calloc(cif_nvalue(cif->ncycle,cif->ncluster),cif->datasize);
       if ( NULL==cif->intensity.i8 ){ goto cif_add_error;}
    }
    if ( ! consistent_cif_headers(cif,newheader) ){ goto cif_add_error;}
-   const uint32_t offset = (newheader->firstcycle - 1) * cif->ncluster * NCHANNEL;
-   switch(cif->datasize){
-       case 1: mem.i8 = cif->intensity.i8 + offset; break;
-       case 2: mem.i16 = cif->intensity.i16 + offset; break;
-       case 3: mem.i32 = cif->intensity.i32 + offset; break;
-       default: errx(EXIT_FAILURE,"Incorrect datasize in %s (%s:%d)\n",__func__,__FILE__,__LINE__);
-   }
-   readCifIntensities(ayb_fp,newheader,mem);
+   if ( cycle + newheader->ncycle > cif->ncycle ){ goto cif_add_error;}
+   const size_t offset = cif_nvalue(cycle,cif->ncluster) * cif->datasize;
+   encInt mem = {.i8 = cif->intensity.i8 + offset};
+   if ( NULL==readCifIntensities(ayb_fp,newheader,mem).i8 ){ goto cif_add_error;}
 
    free_cif(newheader);
    xfclose(ayb_fp);
@@ -476,6 +550,17 @@ cif_add_error:
    return NULL;
 }
 
+/*  Cycle number of a run-folder CIF file, from its directory name C<cycle>.1
+ *  Returns zero if the path does not have this form.
+ */
+static uint32_t cif_path_cycle ( const char * fn ){
+   const char * name = strrchr(fn,'/');
+   if ( NULL==name || name==fn ){ return 0;}
+   const char * dir = name - 1;
+   while ( dir>fn && '/'!=dir[0] ){ dir--; }
+   if ( 'C'!=dir[1] ){ return 0;}
+   return strtoul(dir+2,NULL,10);
+}
 
 char * cif_create_cifglob ( const char * root, const uint32_t lane, const uint32_t tile ){
    if(NULL==root){ return NULL;}
@@ -516,11 +601,11 @@ CIFDATA spliceCIF(const CIFDATA cif, uint32_t ncycle, uint32_t offset){
     newcif->firstcycle = 1;
     newcif->ncycle = ncycle;
 
-    const uint32_t nobs = NCHANNEL*newcif->ncluster*newcif->ncycle;
+    const size_t nobs = cif_nvalue(newcif->ncycle,newcif->ncluster);
     newcif->intensity.i8 = calloc(nobs,newcif->datasize);
     if(NULL==newcif->intensity.i8){ goto clean;}
 
-    uint32_t offset8 = offset*NCHANNEL*newcif->ncluster*cif->datasize;
+    const size_t offset8 = cif_nvalue(offset,newcif->ncluster)*cif->datasize;
     memcpy(newcif->intensity.i8,cif->intensity.i8+offset8,nobs*newcif->datasize);
 
     return newcif;
@@ -532,7 +617,18 @@ clean:
 
 /* Read an entire run from a run directory */
 CIFDATA readCIFfromDir ( const char * root, const uint32_t lane, const uint32_t tile, const XFILE_MODE mode){
+   return readCIFcyclesfromDir(root,lane,tile,mode,NULL,0);
+}
+
+/*  Read the cycles flagged in use, which has nuse elements, from a run directory.
+ *  Only the files for these cycles are opened and the cycles kept are stored
+ * consecutively. If use is null then all cycles found are read.
+ *  Reading stops at the first wanted cycle that is missing, so cif->ncycle is
+ * the number of wanted cycles available in sequence.
+ */
+CIFDATA readCIFcyclesfromDir ( const char * root, const uint32_t lane, const uint32_t tile, const XFILE_MODE mode, const bool * use, uint32_t nuse){
    CIFDATA cif = NULL;
+   uint32_t * position = NULL;
 
    if(NULL==root){ return NULL;}
    if(lane>9){
@@ -548,22 +644,52 @@ CIFDATA readCIFfromDir ( const char * root, const uint32_t lane, const uint32_t
    glob_t g;
    char * cif_glob = cif_create_cifglob(root,lane,tile);
    int ret = glob(cif_glob,0,NULL,&g);
-   if(0!=ret){ goto readCIF_error; }
    free(cif_glob);
+   if(0!=ret){ goto readCIF_error; }
+
+   if(NULL==use){
+      // Want every cycle up to the last found
+      nuse = 0;
+      for ( uint32_t i=0 ; i<g.gl_pathc ; i++){
+         const uint32_t cycle = cif_path_cycle(g.gl_pathv[i]);
+         if(cycle>nuse){ nuse = cycle; }
+      }
+   }
 
-   const uint32_t ncycle = g.gl_pathc;
+   // Position of each wanted cycle in the data, or nuse if not found
+   position = calloc(nuse,sizeof(*position));
+   if(NULL==position && nuse>0){ goto readCIF_error; }
+   for ( uint32_t cy=0 ; cy<nuse ; cy++){ position[cy] = nuse; }
+   for ( uint32_t i=0 ; i<g.gl_pathc ; i++){
+      const uint32_t cycle = cif_path_cycle(g.gl_pathv[i]);
+      if(cycle>0 && cycle<=nuse){ position[cycle-1] = 0; }
+   }
+   // Wanted cycles after a missing one are not read
+   uint32_t ncycle = 0;
+   bool missing = false;
+   for ( uint32_t cy=0 ; cy<nuse ; cy++){
+      const bool found = (0==position[cy]);
+      if(found && !missing && (NULL==use || use[cy])){
+         position[cy] = ncycle++;
+      }
+      else {
+         missing = missing || ((NULL==use || use[cy]) && !found);
+         position[cy] = nuse;
+      }
+   }
 
    cif = new_cif();
+   if(NULL==cif){ goto readCIF_error; }
    cif->ncycle = ncycle;
-   for ( uint32_t i=0 ; i<ncycle ; i++){
-      cif = cif_add_file(g.gl_pathv[i],XFILE_RAW,cif);
+   for ( uint32_t i=0 ; i<g.gl_pathc && NULL!=cif ; i++){
+      const uint32_t cycle = cif_path_cycle(g.gl_pathv[i]);
+      if(0==cycle || cycle>nuse || position[cycle-1]==nuse){ continue; }
+      cif = cif_add_file(g.gl_pathv[i],mode,cif,position[cycle-1]);
       if(NULL==cif){ fprintf(stderr,"Problem reading CIF \"%s\"\n",g.gl_pathv[i]); }
    }
 
-   globfree(&g);
-   return cif;
-
 readCIF_error:
+   free(position);
    globfree(&g);
    return cif;
 }
@@ -593,9 +719,9 @@ void showCIF ( XFILE * ayb_fp, const CIFDATA cif, uint32_t mcluster, uint32_t mc
             for ( int cycle=0 ; cycle<mcycle ; cycle++){
                 float f;
                 switch(cif->datasize){
-                    case 1: f = (float)cif->intensity.i8[(cycle*NCHANNEL+base)*cif->ncluster+cluster]; break;
-                    case 2: f = (float)cif->intensity.i16[(cycle*NCHANNEL+base)*cif->ncluster+cluster]; break;
-                    case 4: f = (float)cif->intensity.i32[(cycle*NCHANNEL+base)*cif->ncluster+cluster]; break;
+                    case 1: f = (float)cif->intensity.i8[cif_index(cif,cluster,base,cycle)]; break;
+                    case 2: f = (float)cif->intensity.i16[cif_index(cif,cluster,base,cycle)]; break;
+                    case 4: f = (float)cif->intensity.i32[cif_index(cif,cluster,base,cycle)]; break;
                     default: f = NAN;
                 }
                 xfprintf( ayb_fp, " %5.0f", f);
@@ -622,9 +748,71 @@ static void timestamp(const char * str, FILE * fp){
     fprintf(fp,"%s%s",c,str);
 }
 
+/*  Synthetic tile of more than 2^32 values, one byte each.
+ *  Memory is allocated on first use and only the values set are touched until the
+ * tile is read back, so the test needs a little over 4G of memory and a few minutes.
+ */
+static const uint32_t LARGE_NCLUSTER = 1 << 24;
+static const uint16_t LARGE_NCYCLE = 65;
+
+struct test_value { uint32_t cl, base, cy; int8_t x; };
+static const struct test_value LARGE_VALUES[] = {
+    {0, 0, 0, 5}, {12345, 2, 64, -7}, {(1 << 24) - 1, 3, 64, 101}
+};
+static const unsigned int NLARGE_VALUE = sizeof(LARGE_VALUES) / sizeof(LARGE_VALUES[0]);
+
+static bool large_values_agree(const CIFDATA cif, const uint32_t cyoffset){
+    for ( unsigned int i=0 ; i<NLARGE_VALUE ; i++){
+        const struct test_value v = LARGE_VALUES[i];
+        if( v.cy<cyoffset ){ continue;}
+        if( cif_get_int(cif,v.cl,v.base,v.cy-cyoffset)!=v.x ){ return false;}
+    }
+    return true;
+}
+
+static int test_large_cif(const char * fn){
+    CIFDATA cif = create_cif(LARGE_NCYCLE, LARGE_NCLUSTER);
+    cif->datasize = 1;
+    const size_t nvalue = cif_nvalue(cif->ncycle,cif->ncluster);
+    xfprintf(xstdout,"Synthetic tile of %u cycles from %u clusters: %zu values, more than 2^32: %s\n",
+             cif->ncycle, cif->ncluster, nvalue, (nvalue>UINT32_MAX)?"yes":"no");
+
+    for ( unsigned int i=0 ; i<NLARGE_VALUE ; i++){
+        const struct test_value v = LARGE_VALUES[i];
+        cif_set_from_real(cif,v.cl,v.base,v.cy,v.x);
+    }
+    if( NULL==cif->intensity.i8 ){ errx(EXIT_FAILURE,"Failed to allocate synthetic tile");}
+    xfprintf(xstdout,"Values set and got back: %s\n",large_values_agree(cif,0)?"yes":"no");
+    /* last value would be stored 2^32 earlier by 32 bit index arithmetic */
+    xfprintf(xstdout,"No value at 32 bit wrapped index: %s\n",
+             (0==cif->intensity.i8[nvalue-1-((size_t)UINT32_MAX+1)])?"yes":"no");
+
+    CIFDATA splice = spliceCIF(cif,1,LARGE_NCYCLE-1);
+    xfprintf(xstdout,"Last cycle spliced: %s\n",
+             (NULL!=splice && large_values_agree(splice,LARGE_NCYCLE-1))?"yes":"no");
+    free_cif(splice);
+
+    timestamp("Writing\n",stderr);
+    bool ok = writeCIFtoFile(cif,fn,XFILE_UNKNOWN);
+    timestamp("Reading\n",stderr);
+    CIFDATA cif2 = readCIFfromFile(fn,XFILE_UNKNOWN);
+    timestamp("Done\n",stderr);
+    ok = ok && NULL!=cif2 && NULL!=cif2->intensity.i8 && cif2->ncluster==cif->ncluster && cif2->ncycle==cif->ncycle;
+    xfprintf(xstdout,"Written and read back identical: %s\n",
+             (ok && 0==memcmp(cif->intensity.i8,cif2->intensity.i8,nvalue))?"yes":"no");
+
+    free_cif(cif2);
+    free_cif(cif);
+    return EXIT_SUCCESS;
+}
+
 int main ( int argc, char * argv[] ){
+    if ( argc==2 ){
+        return test_large_cif(argv[1]);
+    }
     if ( argc!=5 ){
         fputs("./a.out lane tile in_cif_filename out_cif_filename\n",stderr);
+        fputs("./a.out out_cif_filename    (synthetic tile of more than 2^32 values)\n",stderr);
         return EXIT_FAILURE;
     }
 
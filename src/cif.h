@@ -53,7 +53,9 @@ void free_cif ( CIFDATA cif);
 // Other
 CIFDATA readCIFfromFile ( const char * fn, const XFILE_MODE mode);
 CIFDATA readCIFfromStream ( XFILE * ayb_fp );
+CIFDATA readCIFcyclesfromStream ( XFILE * ayb_fp, const bool * use, const uint32_t nuse );
 CIFDATA readCIFfromDir ( const char * fn, const uint32_t lane, const uint32_t tile, const XFILE_MODE mode);
+CIFDATA readCIFcyclesfromDir ( const char * fn, const uint32_t lane, const uint32_t tile, const XFILE_MODE mode, const bool * use, uint32_t nuse);
 bool writeCIFtoFile ( const CIFDATA  cif, const char * fn, const XFILE_MODE mode);
 bool writeCIFtoStream ( const CIFDATA  cif, XFILE * ayb_fp);
 bool write2CIFfile ( const char * fn, const XFILE_MODE mode, const encInt  intensities, const uint16_t firstcycle, const uint32_t ncycle, const uint32_t ncluster, const uint8_t nbyte);
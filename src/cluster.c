@@ -182,6 +182,32 @@ CLUSTER copy_append_CLUSTER(CLUSTER clustout, const CLUSTER clustin, int colstar
     return clustout;
 }
 
+/**
+ * Append clustin onto clustout, selecting data columns without copying them where possible.
+ * clustout may be null, in which case it is created using details from clustin,
+ * with signals that view those of clustin. clustin must not be freed while clustout is in use.
+ * See matrix() view_columns and append_columns for error handling.
+ */
+CLUSTER view_append_CLUSTER(CLUSTER clustout, const CLUSTER clustin, int colstart, int colend){
+
+    /* validate parameters */
+    if(NULL==clustin) {return clustout;}
+
+    if (NULL==clustout){
+        clustout = new_CLUSTER();
+        if(NULL==clustout){ return NULL;}
+        clustout->x = clustin->x;
+        clustout->y = clustin->y;
+        clustout->signals = view_columns(clustin->signals, colstart, colend);
+        if(NULL==clustout->signals){ return free_CLUSTER(clustout);}
+    }
+    else {
+        /* extends the view if columns follow on, else copies */
+        clustout->signals = append_columns(clustout->signals, clustin->signals, colstart, colend);
+    }
+    return clustout;
+}
+
 /*
  * Input functions from data or file
  */
@@ -45,6 +45,7 @@ void show_CLUSTER(XFILE * fp, const CLUSTER cluster);
 // standard variations
 CLUSTER coerce_CLUSTER_from_array(const unsigned int ncycle, int_t * x, int_t ** next);
 CLUSTER copy_append_CLUSTER(CLUSTER clustout, const CLUSTER clustin, int colstart, int colend);
+CLUSTER view_append_CLUSTER(CLUSTER clustout, const CLUSTER clustin, int colstart, int colend);
 
 // Input
 CLUSTER read_cif_CLUSTER(CIFDATA cif, const unsigned int cl, unsigned int ncycle);
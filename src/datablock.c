@@ -53,6 +53,8 @@ static const char *MESS_TEXT = "Blockstring option";    ///< Blockstring option
 static bool DefaultBlock = true;                        ///< Default to all available cycles in one block if no argument.
 static unsigned int TotalCycle = 0;                     ///< Total number of cycles to analyse.
 static unsigned int NumBlock = 0;                       ///< Number of distinct blocks to analyse.
+static unsigned int UsedCycle = 0;                      ///< Number of cycles read or concatenated, excluding ignored.
+static bool *CycleUse = NULL;                           ///< Whether each cycle is used by a read or concatenate block.
 
 /* doxygen confused by LIST */
 /** BlockList = NULL; List of data blocks.
@@ -88,8 +90,35 @@ static BLOCKTYPE decode_token(const char ch) {
 static void free_blocklist(void) {
     free_LIST(DATABLOCK)(BlockList);
     BlockList = NULL;
+    xfree(CycleUse);
+    CycleUse = NULL;
     TotalCycle = 0;
     NumBlock = 0;
+    UsedCycle = 0;
+}
+
+/**
+ * Flag which cycles are used by the blocks in the BlockList.
+ * Returns false if memory could not be allocated.
+ */
+static bool set_cycle_use(void) {
+
+    xfree(CycleUse);
+    UsedCycle = 0;
+    CycleUse = calloc(TotalCycle, sizeof(*CycleUse));
+    if (CycleUse == NULL) {return false;}
+
+    unsigned int cy = 0;
+    for (LIST(DATABLOCK) node = BlockList; node != NULL; node = node->nxt) {
+        const bool used = (node->elt->type != E_IGNORE);
+        for (unsigned int i = 0; i < node->elt->num; i++) {
+            CycleUse[cy++] = used;
+        }
+        if (used) {
+            UsedCycle += node->elt->num;
+        }
+    }
+    return true;
 }
 
 
@@ -150,6 +179,19 @@ unsigned int get_totalcycle(void) {
     return TotalCycle;
 }
 
+/**
+ * Return an array of get_totalcycle() flags, true for each cycle used by a read or concatenate block.
+ * Returns null if the default block is selected, when all available cycles are used.
+ */
+const bool * get_cycle_use(void) {
+    return CycleUse;
+}
+
+/** Return the number of cycles used by read and concatenate blocks, excluding ignored cycles. */
+unsigned int get_usedcycle(void) {
+    return UsedCycle;
+}
+
 /**
  * Parse the blockstring option to find the pattern of data blocks.
  * Stores the result in the BlockList.
@@ -229,6 +271,11 @@ bool parse_blockopt(const char *blockstr) {
         ch = endptr;
     }
 
+    if (ok && !set_cycle_use()) {
+        message(E_NOMEM_S, MSG_FATAL, "cycle use creation");
+        ok = false;
+    }
+
     if (!ok) {
         /* clear the structure */
         free_blocklist();
@@ -54,6 +54,8 @@ bool get_defaultblock(void);
 DATABLOCK get_next_block(void);
 unsigned int get_numblock(void);
 unsigned int get_totalcycle(void);
+const bool * get_cycle_use(void);
+unsigned int get_usedcycle(void);
 bool parse_blockopt(const char *blockstr);
 void tidyup_datablock(void);
 
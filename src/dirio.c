@@ -16,6 +16,10 @@
  *
  * Other files such as predetermined input matrix and spike-in data files are also opened here.
  * 
+ * In service mode a spool directory is watched for job files, each naming input and output locations
+ * and the prefixes or lane/tile ranges to process. A job is claimed by renaming it, so several
+ * services may share a spool directory, and replaced by a status file when finished.
+ *
  * Output file names are generated from the intensities file name by replacing the 'tag' with a new one.
  * The tag is the file suffix for cif files or between the last delimiter and the first dot for txt files. 
  * Any txt compression suffix is also removed as output is always uncompressed.
@@ -84,6 +88,13 @@ static const char *SPIKEIN_TAG = "spike";               ///< Spike-in file tag.
 
 static const char *LTMESS_TEXT = "Lane tile string";    ///< Lane Tile parameter name for messages.
 
+static const char *JOB_TAG = "job";                     ///< Spool job file suffix.
+static const char *RUN_TAG = "run";                     ///< Suffix of a job claimed and running.
+static const char *DONE_TAG = "done";                   ///< Suffix of a finished job status file.
+static const char *STOP_NAME = "stop";                  ///< Spool file requesting the service to stop.
+static const char *JOB_SEP = " \t\r";                  ///< Separators between job file tokens.
+static const char JOB_COMMENT = '#';                    ///< Start of a job file comment.
+
 /**
  * Permission flags for a directory; owner/group all plus other read/execute.
  * Used by output directory create but seems to be ignored in favour of parent adoption.
@@ -128,6 +139,10 @@ static CSTRING Last_Spikein = NULL;             ///< Last spike-in file opened.
 
 static bool Concatenate_Results = false;	///< Concatenate result files
 
+static CSTRING Spool_Path = NULL;               ///< Spool directory watched for jobs, program argument.
+static CSTRING Spool_Input = NULL;              ///< Service input path, used by jobs that do not set one.
+static CSTRING Spool_Output = NULL;             ///< Service output path, used by jobs that do not set one.
+
 
 /* private functions */
 
@@ -429,6 +444,15 @@ static int match_pattern(const struct dirent *list) {
     return ret;
 }
 
+/** Selector function for scandir. Matches a spool job file name. */
+static int match_job(const struct dirent *list) {
+
+    const size_t len = strlen(list->d_name);
+    const size_t taglen = strlen(JOB_TAG);
+    return (len > taglen + 1) && (list->d_name[len - taglen - 1] == DOT)
+            && (strcmp(list->d_name + len - taglen, JOB_TAG) == 0);
+}
+
 /**
  * Move any path parts from filename to file path.
  * If filename contains full path then use alone,
@@ -589,7 +613,7 @@ static CSTRING new_name_body(const CSTRING oldname, const CSTRING tag, int blk)
  * Add a block suffix to the body if non-negative blk supplied.
  * Used for cif and program outputs and additional inputs.
  */
-static CSTRING new_name_suffix(const CSTRING oldname, const CSTRING tag, int blk) {
+static CSTRING new_name_suffix(const CSTRING oldname, const char *tag, int blk) {
 
     if ((oldname == NULL) || (tag == NULL)) {return NULL;}
 
@@ -622,8 +646,8 @@ static CSTRING new_name_suffix(const CSTRING oldname, const CSTRING tag, int blk
             newname[pos++] = BLOCKCHAR + blk;
         }
         newname[pos++] = DOT;
-        for (pnext = tag; pnext < tag + taglen; pnext++) {
-            newname[pos++] = *pnext;
+        for (const char *ptag = tag; ptag < tag + taglen; ptag++) {
+            newname[pos++] = *ptag;
         }
         /* finish with string terminator */
         newname[pos] = '\0';
@@ -818,6 +842,58 @@ bool check_outdir(const CSTRING dirname, const char *type_str) {
     return true;
 }
 
+/**
+ * Claim the first job file in the spool directory by renaming it as running.
+ * A job renamed first by another service is skipped.
+ * Returns the path of the claimed job, or NULL if none waiting.
+ */
+CSTRING claim_job(void) {
+
+    struct dirent **list = NULL;
+    CSTRING jobpath = NULL;
+
+    int num = scandir(Spool_Path, &list, match_job, alphasort);
+    for (int i = 0; i < num; i++) {
+        CSTRING filepath = NULL;
+        if ((jobpath == NULL) && full_path(Spool_Path, list[i]->d_name, &filepath)) {
+            CSTRING runpath = new_name_suffix(filepath, RUN_TAG, BLK_SINGLE);
+            if ((runpath != NULL) && (rename(filepath, runpath) == 0)) {
+                jobpath = runpath;
+            }
+            else {
+                free_CSTRING(runpath);
+            }
+        }
+        free_CSTRING(filepath);
+        free(list[i]);
+    }
+    if (num >= 0) {
+        free(list);
+    }
+    return jobpath;
+}
+
+/**
+ * Replace a claimed job file by a status file with the same name and a done suffix.
+ * The status file gives the result and the elapsed time in seconds.
+ */
+void finish_job(const CSTRING jobpath, const char *result, const double seconds) {
+
+    CSTRING donepath = new_name_suffix(jobpath, DONE_TAG, BLK_SINGLE);
+    if (donepath == NULL) {return;}
+
+    XFILE *fp = xfopen(donepath, XFILE_RAW, "w");
+    if (xfisnull(fp)) {
+        message(E_OPEN_FAIL_SS, MSG_ERR, "Job status", donepath);
+    }
+    else {
+        xfprintf(fp, "status\t%s\nseconds\t%.3f\n", result, seconds);
+    }
+    xfclose(fp);
+    remove(jobpath);
+    free_CSTRING(donepath);
+}
+
 /** Return the name of the current intensities file. */
 CSTRING get_current_file(void) {
 
@@ -998,9 +1074,35 @@ XFILE * open_output(const CSTRING tag) {
  */
 XFILE * open_output_blk(const CSTRING tag, int blk) {
 
+    XFILE *fp = NULL;
+    CSTRING filepath = output_path_blk(tag, blk);
+
+    if (filepath != NULL) {
+        const char *mode_str = ((blk == BLK_APPEND)||Concatenate_Results) ? "a" : "w";
+        fp =  xfopen(filepath, XFILE_UNKNOWN, mode_str );
+
+        if (xfisnull(fp)) {
+            message(E_OPEN_FAIL_SS, MSG_ERR, "Output", filepath);
+            fp = xfclose(fp);
+        }
+        else {
+            message(E_DEBUG_SSD_S, MSG_DEBUG, __func__, __FILE__, __LINE__, filepath);
+        }
+    }
+    free_CSTRING(filepath);
+
+    return fp;
+}
+
+/**
+ * Return the full path of the output file corresponding to current intensities file
+ * with supplied tag, as used by open_output_blk. The path is allocated and must be freed.
+ * Return NULL if no path can be created.
+ */
+CSTRING output_path_blk(const CSTRING tag, int blk) {
+
     CSTRING filename = NULL;
     CSTRING filepath = NULL;
-    XFILE *fp = NULL;
 
     if (Current == NULL) {
         /* use the tag on its own */
@@ -1023,23 +1125,13 @@ XFILE * open_output_blk(const CSTRING tag, int blk) {
     }
 
     if (filename != NULL) {
-        if (full_path(Output_Path, filename, &filepath)) {
-            const char *mode_str = ((blk == BLK_APPEND)||Concatenate_Results) ? "a" : "w";
-            fp =  xfopen(filepath, XFILE_UNKNOWN, mode_str );
-
-            if (xfisnull(fp)) {
-                message(E_OPEN_FAIL_SS, MSG_ERR, "Output", filepath);
-                fp = xfclose(fp);
-            }
-            else {
-                message(E_DEBUG_SSD_S, MSG_DEBUG, __func__, __FILE__, __LINE__, filename);
-            }
+        if (!full_path(Output_Path, filename, &filepath)) {
+            filepath = free_CSTRING(filepath);
         }
     }
     free_CSTRING(filename);
-    free_CSTRING(filepath);
 
-    return fp;
+    return filepath;
 }
 
 /**
@@ -1097,6 +1189,12 @@ XFILE * open_spikein(int blk) {
     }
 }
 
+/** Return if results for multiple tiles are concatenated into a single file. */
+bool concatenate(void) {
+
+    return Concatenate_Results;
+}
+
 /** Return if run-folder selected. */
 bool run_folder(void) {
 
@@ -1130,6 +1228,9 @@ void set_location(const CSTRING path, IOTYPE idx){
         case E_OUTPUT:
             Output_Path = copy_CSTRING(path);
             break;
+        case E_SPOOL:
+            Spool_Path = copy_CSTRING(path);
+            break;
         case E_SPIKEIN:
             Spikearg_Path = copy_CSTRING(path);
             break;
@@ -1204,11 +1305,140 @@ void set_run_folder(void) {
     RunFolder = true;
 }
 
+/**
+ * Set the input and output paths for a job, using the service paths for any that are null.
+ * Checks the input path exists and the output path exists or can be created.
+ * Returns false if either check fails.
+ */
+bool set_job_location(const CSTRING input, const CSTRING output) {
+
+    free_CSTRING(Input_Path);
+    Input_Path = copy_CSTRING((input != NULL) ? input : Spool_Input);
+    free_CSTRING(Output_Path);
+    Output_Path = copy_CSTRING((output != NULL) ? output : Spool_Output);
+
+    if (check_dir(Input_Path) != E_ISDIR) {
+        message(E_BAD_DIR_SS, MSG_ERR, "input", Input_Path);
+        return false;
+    }
+    if (!check_outdir(Output_Path, "output")) {
+         return false;
+    }
+    message(E_INPUT_DIR_SS, MSG_INFO, "Input", Input_Path);
+    message(E_OUTPUT_DIR_S, MSG_INFO, Output_Path);
+    return true;
+}
+
+/**
+ * Read a claimed job file. Tokens are separated by white space and a comment runs to the end of line.
+ * Options -i (--input) and -o (--output) set the job locations; other tokens are the prefixes
+ * or lane/tile ranges to process.
+ * Returns an array of num pattern strings, or NULL if the file cannot be read,
+ * there are none or the locations are not valid. Caller frees the array and strings.
+ */
+CSTRING * read_job(const CSTRING jobpath, int *num) {
+
+    CSTRING input = NULL;
+    CSTRING output = NULL;
+    CSTRING *pattern = NULL;
+    bool ok = true;
+    *num = 0;
+
+    XFILE *fp = xfopen(jobpath, XFILE_UNKNOWN, "r");
+    if (xfisnull(fp)) {
+        message(E_OPEN_FAIL_SS, MSG_ERR, "Job", jobpath);
+        ok = false;
+    }
+
+    char *line = NULL;
+    size_t len = 0;
+    while (ok && ((line = xfgetln(fp, &len)) != NULL)) {
+        char *save = NULL;
+        for (char *tok = strtok_r(line, JOB_SEP, &save); ok && (tok != NULL); tok = strtok_r(NULL, JOB_SEP, &save)) {
+            if (tok[0] == JOB_COMMENT) {break;}
+
+            CSTRING *loc = NULL;
+            if ((strcmp(tok, "-i") == 0) || (strcmp(tok, "--input") == 0)) {
+                loc = &input;
+            }
+            else if ((strcmp(tok, "-o") == 0) || (strcmp(tok, "--output") == 0)) {
+                loc = &output;
+            }
+
+            if (loc != NULL) {
+                /* location follows option */
+                char *path = strtok_r(NULL, JOB_SEP, &save);
+                if (path == NULL) {
+                    message(E_BAD_TXT_SS, MSG_ERR, "Job location", tok);
+                    ok = false;
+                }
+                else {
+                    free_CSTRING(*loc);
+                    *loc = copy_CSTRING(path);
+                }
+            }
+            else {
+                CSTRING *newpattern = realloc(pattern, (*num + 1) * sizeof(*pattern));
+                if (newpattern == NULL) {
+                    message(E_NOMEM_S, MSG_ERR, "job pattern");
+                    ok = false;
+                }
+                else {
+                    pattern = newpattern;
+                    pattern[(*num)++] = copy_CSTRING(tok);
+                }
+            }
+        }
+        free(line);
+    }
+    xfclose(fp);
+
+    if (ok && (*num == 0)) {
+        message(E_NOPATTERN, MSG_ERR);
+        ok = false;
+    }
+    if (ok) {
+        ok = set_job_location(input, output);
+    }
+    if (!ok) {
+        for (int i = 0; i < *num; i++) {
+            free_CSTRING(pattern[i]);
+        }
+        xfree(pattern);
+        pattern = NULL;
+        *num = 0;
+    }
+
+    free_CSTRING(input);
+    free_CSTRING(output);
+    return pattern;
+}
+
 /** Return if spike-in data selected. */
 bool spike_in(void) {
     return (Spikein_Path != NULL);
 }
 
+/** Return if a spool directory is watched for jobs. */
+bool spool_jobs(void) {
+    return (Spool_Path != NULL);
+}
+
+/** Return true, and remove the request, if a stop file has been placed in the spool directory. */
+bool stop_jobs(void) {
+
+    CSTRING stoppath = NULL;
+    bool stop = false;
+    if (full_path(Spool_Path, (CSTRING)STOP_NAME, &stoppath)) {
+        stop = (check_dir(stoppath) != E_NOEXIST);
+        if (stop) {
+            remove(stoppath);
+        }
+    }
+    free_CSTRING(stoppath);
+    return stop;
+}
+
 /**
  * Start up; call at program start after options.
  * Checks input and output directories exists and creates the match substring.
@@ -1240,6 +1470,17 @@ bool startup_dirio(void) {
     message(E_INPUT_DIR_SS, MSG_INFO, "Input", Input_Path);
     message(E_OPT_SELECT_SS, MSG_INFO, "Input format" ,INFORM_MESS_TEXT[Input_Format]);
 
+    /* check specified spool path exists and keep the service paths for jobs */
+    if (Spool_Path != NULL) {
+        if (check_dir(Spool_Path) != E_ISDIR) {
+            message(E_BAD_DIR_SS, MSG_FATAL, "spool", Spool_Path);
+            return false;
+        }
+        Spool_Input = copy_CSTRING(Input_Path);
+        Spool_Output = copy_CSTRING(Output_Path);
+        message(E_INPUT_DIR_SS, MSG_INFO, "Jobs", Spool_Path);
+    }
+
     /* check for run-folder */
     if (RunFolder) {
         if (Input_Format == E_CIF) {
@@ -1276,6 +1517,9 @@ void tidyup_dirio(void) {
     /* free string memory */
     Input_Path = free_CSTRING(Input_Path);
     Output_Path = free_CSTRING(Output_Path);
+    Spool_Path = free_CSTRING(Spool_Path);
+    Spool_Input = free_CSTRING(Spool_Input);
+    Spool_Output = free_CSTRING(Spool_Output);
     IntenSubstr = free_CSTRING(IntenSubstr);
     Spikearg_Path = free_CSTRING(Spikearg_Path);
     Spikein_Path = free_CSTRING(Spikein_Path);
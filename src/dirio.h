@@ -46,7 +46,7 @@ typedef enum InFormT {E_TXT, E_CIF, E_INFORM_NUM} INFORM;
  * Types of file location information. Also used as index into predetermined input matrices.
  * E_NMATRIX indicates total number of such matrices, and E_MNP the modelling ones.
  */
-typedef enum IOTypeT {E_CROSSTALK, E_NOISE, E_PARAMA, E_QUALTAB, E_SPIKEIN, E_INPUT, E_OUTPUT, E_MNP = 3, E_NMATRIX = 4} IOTYPE;
+typedef enum IOTypeT {E_CROSSTALK, E_NOISE, E_PARAMA, E_QUALTAB, E_SPIKEIN, E_INPUT, E_OUTPUT, E_SPOOL, E_MNP = 3, E_NMATRIX = 4} IOTYPE;
 
 /**
  * Open output file special block options.
@@ -61,6 +61,9 @@ typedef struct LaneTileT {unsigned int lane; unsigned int tile;} LANETILE;
 /* function prototypes */
 
 bool check_outdir(const CSTRING dirname, const char * type_str);
+CSTRING claim_job(void);
+bool concatenate(void);
+void finish_job(const CSTRING jobpath, const char *result, const double seconds);
 CSTRING get_current_file(void);
 INFORM get_input_format(void);
 CSTRING get_input_path(void);
@@ -73,17 +76,22 @@ XFILE * open_matrix(IOTYPE mode);
 XFILE * open_next(XFILE *fplast);
 XFILE * open_output(const CSTRING tag);
 XFILE * open_output_blk(const CSTRING tag, int blk);
+CSTRING output_path_blk(const CSTRING tag, int blk);
 XFILE * open_run_output(const CSTRING tag);
 XFILE * open_spikein(int blk);
 
 bool run_folder(void);
+CSTRING * read_job(const CSTRING jobpath, int *num);
 bool set_input_format(const char *inform_str);
+bool set_job_location(const CSTRING input, const CSTRING output);
 void set_location(const CSTRING path, IOTYPE mode);
 void set_sample_name(const CSTRING sample_name);
 bool set_pattern(const CSTRING pattern);
 void set_run_folder(void);
 void set_concatenate(void);
 bool spike_in(void);
+bool spool_jobs(void);
+bool stop_jobs(void);
 
 bool startup_dirio(void);
 void tidyup_dirio(void);
@@ -145,7 +145,7 @@ MAT expected_intensities(const real_t lambda, const NUC * bases,
  * Solves the linear system vec(I_i-N) = A vec(S_i).
  * The input is the LU decomposition of the transpose of A.
  */
-MAT processNew(const struct structLU AtLU, const MAT N, const MAT intensities, MAT p){
+HOT_KERNEL MAT processNew(const struct structLU AtLU, const MAT N, const MAT intensities, MAT p){
     if (NULL==AtLU.mat || NULL==N || NULL==intensities) { return NULL;}
 
     const int ncycle = N->ncol;
@@ -114,7 +114,7 @@ real_t estimate_lambdaWLS( const MAT p, const NUC * base, const real_t oldlambda
  * vec(I_i - N) = lambda_i A vec(S_i)
  * \n Solution is y^t A s / s^tA^tAs where y = Vec(I_i - N) and s = Vec(S_i)
  */
-real_t estimate_lambda_A ( const MAT intensity, const MAT N, const MAT At, const NUC * base){
+HOT_KERNEL real_t estimate_lambda_A ( const MAT intensity, const MAT N, const MAT At, const NUC * base){
     if(NULL==intensity || NULL==N || NULL==At || NULL==base){ return NAN; }
     const uint_fast32_t ncycle = intensity->ncol;
 
@@ -140,3 +140,40 @@ real_t estimate_lambda_A ( const MAT intensity, const MAT N, const MAT At, const
     real_t lambda = sAy/sAAs;
     return (lambda>0.)?lambda:0.;
 }
+
+/**
+ * Estimate lambda by least square, using a precomputed column table of A.
+ * Same solution and arithmetic as estimate_lambda_A, so results are identical,
+ * but A vec(S_i) is built by adding one contiguous column of A per cycle
+ * rather than by gathering each element across the rows of At.
+ * - A:          Parameter matrix, not transposed; column cycle * NBASE + base
+ *               is the response to that base in that cycle. Form once per iteration.
+ */
+HOT_KERNEL real_t estimate_lambda_cols ( const MAT intensity, const MAT N, const MAT A, const NUC * base){
+    if(NULL==intensity || NULL==N || NULL==A || NULL==base){ return NAN; }
+    const uint_fast32_t ncycle = intensity->ncol;
+
+    // Calculate A vec(S_i) as sum of selected columns
+    const int lda = NBASE*ncycle;
+    real_t As[lda];
+    for ( int i=0 ; i<lda ; i++){
+        As[i] = 0.;
+    }
+    for ( int j=0 ; j<ncycle ; j++){
+        const real_t * Acol = A->x + (j*NBASE+base[j])*lda;
+        for ( int i=0 ; i<lda ; i++){
+            As[i] += Acol[i];
+        }
+    }
+    // Numerator and denominator of solution
+    real_t sAAs = 0.0;
+    real_t sAy = 0.0;
+    for ( int i=0 ; i<lda ; i++){
+        sAAs += As[i]*As[i];
+        sAy += (intensity->xint[i]-N->x[i]) * As[i];
+    }
+
+    // Ensure that lambda is sufficiently positive.
+    real_t lambda = sAy/sAAs;
+    return (lambda>0.)?lambda:0.;
+}
@@ -73,6 +73,9 @@ void F77_NAME(sgetrs)( const char * trans, const int * N, const int * NRHS, cons
 
 void F77_NAME(ssyr)(   const char * uplo, const int * N, const float * alpha, const float * x,
                        const int * incx, float * A, const int * lda);
+void F77_NAME(ssyrk)(  const char * uplo, const char * trans, const int * N, const int * K,
+                       const float * alpha, const float * A, const int * lda,
+                       const float * beta, float * C, const int * ldc);
 
 // Non-LAPACK routine for non-negative least squares
 void F77_NAME(snnls)(  float *A, const int * MDA, const int * M, const int* N, float * B, float * X, 
@@ -108,6 +111,9 @@ void F77_NAME(dgetrs)( const char * trans, const int * N, const int * NRHS, cons
 
 void F77_NAME(dsyr)(   const char * uplo, const int * N, const double * alpha, const double * x,
                        const int * incx, double * A, const int * lda);
+void F77_NAME(dsyrk)(  const char * uplo, const char * trans, const int * N, const int * K,
+                       const double * alpha, const double * A, const int * lda,
+                       const double * beta, double * C, const int * ldc);
 
 // Non-LAPACK routine for non-negative least squares
 void F77_NAME(dnnls)(  double *A, const int * MDA, const int * M, const int* N, double * B, double * X, 
@@ -128,6 +134,7 @@ void F77_NAME(dnnls)(  double *A, const int * MDA, const int * M, const int* N,
     #define getri   F77_NAME(sgetri)
     #define getrs   F77_NAME(sgetrs)
     #define syr     F77_NAME(ssyr)
+    #define syrk    F77_NAME(ssyrk)
     #define nnls    F77_NAME(snnls)
 #else
     #define potrf   F77_NAME(dpotrf)
@@ -142,6 +149,7 @@ void F77_NAME(dnnls)(  double *A, const int * MDA, const int * M, const int* N,
     #define getri   F77_NAME(dgetri)
     #define getrs   F77_NAME(dgetrs)
     #define syr     F77_NAME(dsyr)
+    #define syrk    F77_NAME(dsyrk)
     #define nnls    F77_NAME(dnnls)
 #endif
 
@@ -0,0 +1,260 @@
+/**
+ * \file libayb.c
+ * Embeddable AYB library.
+ * A context holds the settings of a caller; each call models one set of intensities
+ * supplied in a caller owned buffer and returns the bases and qualities in caller buffers.
+ *
+ * The intensity buffer is viewed in place, not copied; it is ordered by cluster, then cycle,
+ * then channel, the same order as the intensities of a tile.
+ * Each call creates and frees its own model so separate contexts may be used concurrently
+ * from different threads. The program options are shared configuration read during analysis;
+ * an embedding program uses the defaults and does not call the option setting functions
+ * while any context is calling.
+ *//*
+ *  Created : 16 Oct 2026
+ *
+ *  Copyright (C) 2010 European Bioinformatics Institute
+ *
+ *  This file is part of the AYB base calling software.
+ *
+ *  AYB is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  AYB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with AYB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "libayb.h"
+#include "ayb.h"
+#include "aybthread.h"
+#include "dirio.h"
+#include "qual_table.h"
+#include "tile.h"
+
+
+/* constants */
+
+static const unsigned int DEFAULT_NITER = 5;    ///< Number of iterations in base call loop, as program.
+static const unsigned int MIN_CYCLE = 2;        ///< Minimum cycles for modelling.
+
+
+/* members */
+
+static bool Initialised = false;                ///< Library wide tables made.
+
+/** Settings of a library caller. */
+struct AybContextT {
+    unsigned int niter;                         ///< Number of iterations in base call loop.
+    unsigned int nthread;                       ///< Threads for each call, zero for the default.
+};
+
+
+/* private functions */
+
+/**
+ * Run the base calling loop of a model, the last iteration calling final bases and qualities.
+ * Returns false if processing terminated on error.
+ */
+static bool run_model(AYB ayb, const unsigned int niter) {
+
+    for (unsigned int i = 0; i < niter; i++){
+        if (isnan(estimate_MPN(ayb))) {
+            return false;
+        }
+        if (estimate_bases(ayb, BLK_SINGLE, (i == (niter - 1)), false) == DATA_ERR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* public functions */
+
+/* standard functions */
+
+/**
+ * Create a new library context with the default settings.
+ * The first context also makes the library wide tables, here the default quality calibration.
+ * Returns null if no memory or the tables could not be made.
+ */
+AYBCONTEXT new_AYBCONTEXT(void) {
+
+    bool ok = true;
+    #pragma omp critical (libayb_init)
+    {
+        if (!Initialised) {
+            Initialised = read_quality_table();
+            ok = Initialised;
+        }
+    }
+    if (!ok) {return NULL;}
+
+    AYBCONTEXT ctx = calloc(1, sizeof(*ctx));
+    if (NULL == ctx) {return NULL;}
+
+    ctx->niter = DEFAULT_NITER;
+    ctx->nthread = 0;
+    return ctx;
+}
+
+/** Free a library context. Returns null. */
+AYBCONTEXT free_AYBCONTEXT(AYBCONTEXT ctx) {
+
+    if (NULL != ctx) {
+        free(ctx);
+    }
+    return NULL;
+}
+
+/** Set the number of iterations in the base call loop. Returns false if not a valid number. */
+bool set_AYBCONTEXT_niter(AYBCONTEXT ctx, const unsigned int niter) {
+
+    if ((NULL == ctx) || (niter == 0)) {return false;}
+    ctx->niter = niter;
+    return true;
+}
+
+/** Set the number of threads used by each call of a context, zero for the default. */
+void set_AYBCONTEXT_threads(AYBCONTEXT ctx, const unsigned int nthread) {
+
+    if (NULL == ctx) {return;}
+    ctx->nthread = nthread;
+}
+
+/**
+ * Call bases and qualities for a set of intensities.
+ * Intensities are ncluster x ncycle x 4 channel values, ordered by cluster, then cycle, then channel.
+ * Bases and qualities are returned as ncluster x ncycle characters ordered by cluster then cycle,
+ * bases as letters and qualities as phred characters; neither is null terminated.
+ * Returns false if the intensities could not be modelled, in which case the outputs are undefined.
+ */
+bool call_AYBCONTEXT(AYBCONTEXT ctx, const int16_t * intensities, const uint32_t ncluster,
+                     const uint32_t ncycle, char * bases, char * quals) {
+
+    if ((NULL == ctx) || (NULL == intensities) || (NULL == bases) || (NULL == quals)) {return false;}
+    if ((ncluster == 0) || (ncycle < MIN_CYCLE)) {return false;}
+
+    bool ok = false;
+    AYB ayb = NULL;
+    /* threads of this call only; the caller's setting is restored on return */
+    const int callerthread = omp_get_max_threads();
+
+    /* view the caller intensities in place; signals are only read */
+    TILE tile = coerce_TILE_from_array(ncluster, ncycle, (int_t *)intensities);
+    if (NULL == tile) {return false;}
+
+    ayb = new_AYB(ncycle, ncluster);
+    if (NULL == ayb) {goto cleanup;}
+    ayb = replace_AYB_tile(ayb, tile);
+
+    if (ctx->nthread > 0) {
+        omp_set_num_threads(ctx->nthread);
+    }
+
+    if (!initialise_model(ayb, BLK_SINGLE, false)) {goto cleanup;}
+    if (!run_model(ayb, ctx->niter)) {goto cleanup;}
+
+    get_AYB_calls(ayb, bases, quals);
+    ok = true;
+
+cleanup:
+    /* tile matrices are shared with the caller buffer, which is not freed */
+    free_AYB(ayb);
+    free_TILE(tile);
+    if (ctx->nthread > 0) {
+        omp_set_num_threads(callerthread);
+    }
+    return ok;
+}
+
+
+#ifdef TEST
+#include <err.h>
+#include <string.h>
+#include "cif.h"
+#include "nuc.h"
+
+static const unsigned int NSHOW = 5;            ///< Number of reads shown.
+
+int main(int argc, char * argv[]){
+    if(argc<2){
+        /* argument is a cif input file */
+        errx(EXIT_FAILURE, "Usage: test-libayb cif_filename");
+    }
+
+    CIFDATA cif = readCIFfromFile(argv[1], XFILE_UNKNOWN);
+    if (NULL == cif) {
+        errx(EXIT_FAILURE, "Failed to read supplied cif file");
+    }
+
+    /* copy the intensities into a caller buffer ordered by cluster, cycle, channel */
+    const uint32_t ncluster = cif_get_ncluster(cif);
+    const uint32_t ncycle = cif_get_ncycle(cif);
+    const size_t ncall = (size_t)ncluster * ncycle;
+    int16_t *intensities = calloc(ncall * NBASE, sizeof(*intensities));
+    char *bases[2] = {calloc(ncall, 1), calloc(ncall, 1)};
+    char *quals[2] = {calloc(ncall, 1), calloc(ncall, 1)};
+    if ((NULL == intensities) || (NULL == bases[0]) || (NULL == bases[1])
+        || (NULL == quals[0]) || (NULL == quals[1])) {
+        errx(EXIT_FAILURE, "Failed to allocate buffers");
+    }
+    for (uint32_t cl = 0; cl < ncluster; cl++) {
+        for (uint32_t cy = 0; cy < ncycle; cy++) {
+            for (uint32_t b = 0; b < NBASE; b++) {
+                intensities[((size_t)cl * ncycle + cy) * NBASE + b] = cif_get_int(cif, cl, b, cy);
+            }
+        }
+    }
+    free_cif(cif);
+    xfprintf(xstdout, "Intensities of %u clusters and %u cycles\n", ncluster, ncycle);
+
+    xfputs("Context settings\n", xstdout);
+    AYBCONTEXT ctx[2] = {new_AYBCONTEXT(), new_AYBCONTEXT()};
+    xfprintf(xstdout, "Set zero iterations: %s\n", set_AYBCONTEXT_niter(ctx[0], 0) ? "true, not ok" : "false, ok");
+    xfprintf(xstdout, "Call null intensities: %s\n",
+             call_AYBCONTEXT(ctx[0], NULL, ncluster, ncycle, bases[0], quals[0]) ? "true, not ok" : "false, ok");
+    xfprintf(xstdout, "Call one cycle: %s\n",
+             call_AYBCONTEXT(ctx[0], intensities, ncluster, 1, bases[0], quals[0]) ? "true, not ok" : "false, ok");
+
+    xfputs("Call two contexts concurrently\n", xstdout);
+    bool ret[2] = {false, false};
+    omp_set_max_active_levels(2);
+    #pragma omp parallel for num_threads(2)
+    for (int i = 0; i < 2; i++) {
+        set_AYBCONTEXT_threads(ctx[i], 2);
+        ret[i] = call_AYBCONTEXT(ctx[i], intensities, ncluster, ncycle, bases[i], quals[i]);
+    }
+    xfprintf(xstdout, "Returns: %s %s\n", ret[0] ? "true" : "false", ret[1] ? "true" : "false");
+    xfprintf(xstdout, "Calls agree: %s\n",
+             ((memcmp(bases[0], bases[1], ncall) == 0) && (memcmp(quals[0], quals[1], ncall) == 0)) ? "yes" : "no");
+
+    xfputs("Call with context threads\n", xstdout);
+    const int callerthread = omp_get_max_threads();
+    set_AYBCONTEXT_threads(ctx[1], 3);
+    call_AYBCONTEXT(ctx[1], intensities, ncluster, ncycle, bases[1], quals[1]);
+    xfprintf(xstdout, "Caller threads restored: %s\n", (omp_get_max_threads() == callerthread) ? "yes" : "no");
+
+    xfputs("First reads\n", xstdout);
+    for (uint32_t cl = 0; (cl < NSHOW) && (cl < ncluster); cl++) {
+        xfprintf(xstdout, "%.*s\n%.*s\n", (int)ncycle, bases[0] + cl * ncycle, (int)ncycle, quals[0] + cl * ncycle);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        ctx[i] = free_AYBCONTEXT(ctx[i]);
+        free(bases[i]);
+        free(quals[i]);
+    }
+    free(intensities);
+    return EXIT_SUCCESS;
+}
+#endif
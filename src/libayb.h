@@ -0,0 +1,52 @@
+/**
+ * \file libayb.h
+ * Public parts of the embeddable AYB library.
+ * Calls bases and qualities from intensities held in memory by the caller,
+ * without any file input or output. Link with libayb.a or libayb.so.
+ *//*
+ *  Created : 16 Oct 2026
+ *
+ *  Copyright (C) 2010 European Bioinformatics Institute
+ *
+ *  This file is part of the AYB base calling software.
+ *
+ *  AYB is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  AYB is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with AYB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBAYB_H_
+#define LIBAYB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/** Library context defined as a hidden data structure. Access via structure pointer. */
+typedef struct AybContextT * AYBCONTEXT;
+
+
+/* function prototypes */
+
+/* standard functions */
+AYBCONTEXT new_AYBCONTEXT(void);
+AYBCONTEXT free_AYBCONTEXT(AYBCONTEXT ctx);
+
+/* settings */
+bool set_AYBCONTEXT_niter(AYBCONTEXT ctx, const unsigned int niter);
+void set_AYBCONTEXT_threads(AYBCONTEXT ctx, const unsigned int nthread);
+
+/* base calling */
+bool call_AYBCONTEXT(AYBCONTEXT ctx, const int16_t * intensities, const uint32_t ncluster,
+                     const uint32_t ncycle, char * bases, char * quals);
+
+#endif /* LIBAYB_H_ */
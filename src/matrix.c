@@ -78,6 +78,7 @@ MAT new_MAT_int( const int nrow, const int ncol, const bool useint ) {
     mat->ncol=ncol;
     mat->nrow=nrow;
     mat->useint = useint;
+    mat->shared = false;
     /* Number of rows or columns might be zero but probably an error, so warn
      * as such. Want to avoid malloc(0) since this is "implementation defined"
      * in the C standard, may be a real address that should not be used or NULL
@@ -91,11 +92,11 @@ MAT new_MAT_int( const int nrow, const int ncol, const bool useint ) {
          /* Usual case. Use calloc rather than malloc so elements are initialised */
          bool memfail = false;
          if (useint) {
-             mat->xint = calloc(nrow*ncol,sizeof(int_t));
+             mat->xint = calloc((size_t)nrow*ncol,sizeof(int_t));
              memfail = (NULL==mat->xint);
          }
          else {
-             mat->x = calloc(nrow*ncol,sizeof(real_t));
+             mat->x = calloc((size_t)nrow*ncol,sizeof(real_t));
              memfail = (NULL==mat->x);
          }
 
@@ -112,8 +113,11 @@ MAT new_MAT_int( const int nrow, const int ncol, const bool useint ) {
 /* Free memory allocated for matrix */
 MAT free_MAT ( MAT mat ){
     if(NULL==mat){ return NULL; }
-    /* free real or int array */
-    if (mat->useint) {
+    /* free real or int array unless held elsewhere */
+    if (mat->shared) {
+        /* only free top structure */
+    }
+    else if (mat->useint) {
         if ( NULL!=mat->xint){
             xfree(mat->xint);
         }
@@ -136,10 +140,10 @@ MAT copy_MAT( const MAT mat){
 
     /* copy real or int array */
     if (mat->useint) {
-        memcpy(newmat->xint,mat->xint,mat->nrow*mat->ncol*sizeof(int_t));
+        memcpy(newmat->xint,mat->xint,(size_t)mat->nrow*mat->ncol*sizeof(int_t));
     }
     else {
-        memcpy(newmat->x,mat->x,mat->nrow*mat->ncol*sizeof(real_t));
+        memcpy(newmat->x,mat->x,(size_t)mat->nrow*mat->ncol*sizeof(real_t));
     }
     return newmat;
 }
@@ -192,7 +196,7 @@ MAT new_MAT_from_array( const uint_fast32_t nrow, const uint_fast32_t ncol, cons
     if(NULL==x){ return NULL;}
     MAT mat = new_MAT(nrow,ncol);
     if(NULL==mat){return NULL;}
-    memcpy(mat->x,x,nrow*ncol*sizeof(real_t));
+    memcpy(mat->x,x,(size_t)nrow*ncol*sizeof(real_t));
     return mat;
 }
 
@@ -207,7 +211,9 @@ MAT coerce_MAT_from_array(const uint_fast32_t nrow, const uint_fast32_t ncol, re
     mat->nrow = nrow;
     mat->ncol = ncol;
     mat->useint = false;
+    mat->shared = true;
     mat->x = x;
+    mat->xint = NULL;
     return mat;
 }
 
@@ -222,7 +228,9 @@ MAT coerce_MAT_from_intarray(const uint_fast32_t nrow, const uint_fast32_t ncol,
     mat->nrow = nrow;
     mat->ncol = ncol;
     mat->useint = true;
+    mat->shared = true;
     mat->xint = x;
+    mat->x = NULL;
     return mat;
 }
 
@@ -241,7 +249,7 @@ MAT copyinto_MAT( MAT newmat, const MAT mat){
     if(NULL==newmat || NULL==mat){ return NULL;}
     if(newmat->nrow!=mat->nrow){ return NULL;}
     if(newmat->ncol!=mat->ncol){ return NULL;}
-    memcpy(newmat->x,mat->x,mat->nrow*mat->ncol*sizeof(real_t));
+    memcpy(newmat->x,mat->x,(size_t)mat->nrow*mat->ncol*sizeof(real_t));
     return newmat;
 }
 
@@ -255,6 +263,9 @@ MAT copyinto_MAT( MAT newmat, const MAT mat){
  * - matin and matout do no have the same value type (warning issued)
  * - matout is not empty and extend fails
  *
+ * If matout is a view (see view_columns) it is lengthened when the columns follow on in
+ * the same values, otherwise the viewed values are first copied.
+ *
  * Returns NULL if:
  *  - matout is empty and create fails
  *
@@ -302,9 +313,40 @@ MAT append_columns(MAT matout, const MAT matin, int colstart, int colend) {
         matout = new_MAT_int(nrow, newcol, matin->useint);
         validate(NULL != matout, NULL);
     }
+    else if (matout->shared) {
+        /* a view that ends where the appended columns start can simply be lengthened */
+        const bool follows = matout->useint ?
+                (matout->xint + colout * nrow == matin->xint + colstart * nrow) :
+                (matout->x + colout * nrow == matin->x + colstart * nrow);
+        if (follows) {
+            matout->ncol = newcol;
+            return matout;
+        }
+        /* otherwise take a copy of the viewed values to extend */
+        if (matout->useint) {
+            int_t * tmp = malloc((size_t)nrow * newcol * sizeof(int_t));
+            if (NULL == tmp) {
+                WARN_MEM("matrix append");
+                return matout;
+            }
+            memcpy(tmp, matout->xint, (size_t)nrow * colout * sizeof(int_t));
+            matout->xint = tmp;
+        }
+        else {
+            real_t * tmp = malloc((size_t)nrow * newcol * sizeof(real_t));
+            if (NULL == tmp) {
+                WARN_MEM("matrix append");
+                return matout;
+            }
+            memcpy(tmp, matout->x, (size_t)nrow * colout * sizeof(real_t));
+            matout->x = tmp;
+        }
+        matout->shared = false;
+        matout->ncol = newcol;
+    }
     else {
         if (matout->useint) {
-            int_t * tmp = realloc(matout->xint, nrow * newcol * sizeof(int_t));
+            int_t * tmp = realloc(matout->xint, (size_t)nrow * newcol * sizeof(int_t));
             if (NULL == tmp) {
                 WARN_MEM("matrix append");
                 return matout;
@@ -312,7 +354,7 @@ MAT append_columns(MAT matout, const MAT matin, int colstart, int colend) {
             matout->xint = tmp;
         }
         else {
-            real_t * tmp = realloc(matout->x, nrow * newcol * sizeof(real_t));
+            real_t * tmp = realloc(matout->x, (size_t)nrow * newcol * sizeof(real_t));
             if (NULL == tmp) {
                 WARN_MEM("matrix append");
                 return matout;
@@ -325,21 +367,51 @@ MAT append_columns(MAT matout, const MAT matin, int colstart, int colend) {
     /* copy selected columns to append */
     if (matout->useint) {
         memcpy(matout->xint + colout * nrow, matin->xint + colstart * nrow,
-               nrow * (colend - colstart + 1) * sizeof(int_t));
+               (size_t)nrow * (colend - colstart + 1) * sizeof(int_t));
     }
     else {
         memcpy(matout->x + colout * nrow, matin->x + colstart * nrow,
-               nrow * (colend - colstart + 1) * sizeof(real_t));
+               (size_t)nrow * (colend - colstart + 1) * sizeof(real_t));
     }
 
     return matout;
 }
 
+/**
+ * Create a matrix viewing columns, from colstart to colend inclusive, of matin.
+ * Values are not copied; the view refers to those of matin, which must not be freed or
+ * reallocated while the view is in use. The view may be freed with free_MAT.
+ * Appending further columns to a view with append_columns lengthens the view if they follow on
+ * in the same values, else a copy is made.
+ * Returns NULL if matin is null, the column range is invalid or memory allocation fails.
+ */
+MAT view_columns(const MAT matin, int colstart, int colend) {
+
+    validate(NULL != matin, NULL);
+    if ((colstart < 0) || (colstart > colend) || (colend >= matin->ncol)) {
+        warnx("Matrix view_columns: invalid column range %d to %d of %d.", colstart, colend, matin->ncol);
+        return NULL;
+    }
+
+    MAT mat = malloc(sizeof(*mat));
+    if (NULL == mat) {
+        WARN_MEM("matrix view");
+        return NULL;
+    }
+    mat->nrow = matin->nrow;
+    mat->ncol = colend - colstart + 1;
+    mat->useint = matin->useint;
+    mat->shared = true;
+    mat->x = matin->useint ? NULL : matin->x + colstart * matin->nrow;
+    mat->xint = matin->useint ? matin->xint + colstart * matin->nrow : NULL;
+    return mat;
+}
+
 /** Set all elements in a supplied real value matrix to the specified value. */
 MAT set_MAT( MAT mat, const real_t x){
     if(NULL==mat){ return NULL;}
-    const uint_fast32_t nelt = mat->nrow * mat->ncol;
-    for ( uint_fast32_t i=0 ; i<nelt ; i++){
+    const size_t nelt = (size_t)mat->nrow * mat->ncol;
+    for ( size_t i=0 ; i<nelt ; i++){
         mat->x[i] = x;
     }
     return mat;
@@ -776,8 +848,8 @@ cleanup:
 
 MAT scale_MAT(MAT mat, const real_t f){
     validate(NULL!=mat,NULL);
-    const uint_fast32_t nelt = mat->ncol * mat->nrow;
-    for ( uint_fast32_t elt=0 ; elt<nelt ; elt++){
+    const size_t nelt = (size_t)mat->ncol * mat->nrow;
+    for ( size_t elt=0 ; elt<nelt ; elt++){
             mat->x[elt] *= f;
     }
     return mat;
@@ -908,7 +980,7 @@ real_t xMy( const real_t * x, const MAT M, const real_t * y){
  * @param Om            block-diagonal matrix
  * @return              Result
  */
-real_t xOx(const real_t * x, const uint_fast32_t nblock, const uint_fast32_t blocksize, const MAT Om){
+HOT_KERNEL real_t xOx(const real_t * x, const uint_fast32_t nblock, const uint_fast32_t blocksize, const MAT Om){
     validate(NULL!=x,NAN);
     validate(NULL!=Om,NAN);
     validate(Om->ncol==Om->nrow,NAN);
@@ -997,7 +1069,7 @@ MAT copy_MAT_int(const MAT mat) {
 
     if (mat->useint) {
         /* can do a memory copy */
-        memcpy(newmat->xint, mat->xint, mat->nrow * mat->ncol * sizeof(int_t));
+        memcpy(newmat->xint, mat->xint, (size_t)mat->nrow * mat->ncol * sizeof(int_t));
     }
     else {
         /* copy values, ensuring within range */
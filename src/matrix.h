@@ -44,12 +44,14 @@ typedef int16_t int_t;                          ///< Define size of integer data
 /**
  * Matrix structure includes size and whether data stored as real or integer.
  * Use of integer reduces memory requirements.
+ * A shared matrix references values held elsewhere, which are not freed with it.
  */
 struct _matrix_str {
     int    nrow, ncol;
     real_t * x;
     int_t  * xint;
     bool   useint;
+    bool   shared;
     };
 
 // Make future abstraction easier
@@ -72,6 +74,7 @@ MAT coerce_MAT_from_intarray(const uint_fast32_t nrow, const uint_fast32_t ncol,
 MAT identity_MAT( const int nrow);
 MAT copyinto_MAT( MAT matout, const MAT matin);
 MAT append_columns(MAT matout, const MAT matin, int colstart, int colend);
+MAT view_columns(const MAT matin, int colstart, int colend);
 MAT set_MAT( MAT mat, const real_t x);
 
 // stream i/o
@@ -69,6 +69,13 @@ static const char *MSG_TEXT[] = {
         "Failed to initialise %s matrix\n",                                     // E_MATRIX_FAIL_S
         "Failed to create %s\n",                                                // E_NOCREATE_S
         "Zero lambdas per iteration: %s\n",                                     // E_ZERO_LAMBDA_S
+        "Starting job: %s\n",                                                   // E_JOB_START_S
+        "Tile completed by an earlier run, skipped: %s\n",                      // E_TILE_COMPLETE_S
+        "Failed to write checkpoint: %s\n",                                     // E_CHECKPOINT_FAIL_S
+        "Checkpoint unusable, block starts from the beginning: %s\n",           // E_CHECKPOINT_BAD_S
+        "Parameter bundle format, version or byte order not recognised: %s\n",  // E_BAD_BUNDLE_S
+        "Failed to write parameter bundle: %s\n",                               // E_BUNDLE_FAIL_S
+        "No clusters of the selected range in input: %s\n",                     // E_NOCLUSTER_S
         "",                                                                     // E_END_S
         "%s from directory: %s\n",                                              // E_INPUT_DIR_SS
         "Input %s file found: %s\n",                                            // E_INPUT_FOUND_SS
@@ -82,12 +89,15 @@ static const char *MSG_TEXT[] = {
         "%s selected: %s\n",                                                    // E_OPT_SELECT_SS
         "%s error; %s\n",                                                       // E_BAD_TXT_SS
         "%s contains invalid numeric: \'%s\'\n",                                // E_BAD_NUM_SS
+        "Finished job: %s; %s\n",                                               // E_JOB_END_SS
         "",                                                                     // E_END_SS
         "%s contains invalid character: \'%c\'\n",                              // E_BAD_CHAR_SC
         "",                                                                     // E_END_SC
         "Input file pattern match: \'%s\'; %d file(s) found\n",                 // E_PATTERN_MATCH_SD
         "Number of %s selected: %d\n",                                          // E_OPT_SELECT_SD
         "Invalid cluster number in %s: %d\n",                                   // E_BAD_CLUSTER_SD
+        "Warm start (%s) of model parameters from %d previous tile(s)\n",       // E_WARMSTART_SD
+        "Resuming from checkpoint %s after iteration %d\n",                     // E_CHECKPOINT_RESUME_SD
         "",                                                                     // E_END_SD
         "%s matrix wrong size, need dimension %d not %d\n",                     // E_MATRIXINIT_SDD
         "",                                                                     // E_END_SDD
@@ -98,15 +108,29 @@ static const char *MSG_TEXT[] = {
         "Thin clusters with %d or more zero data cycles\n",                     // E_ZEROTHIN_D
         "Processing failed at iteration %d; calls set to null\n",               // E_PROCESS_FAIL_D
         "Insufficient cycles for model; %d selected or found\n",                // E_CYCLESIZE_D
+        "Model parameters held fixed from lane %d estimation\n",                // E_LANEPARAM_D
+        "Messages from worker %d:\n",                                           // E_WORKER_LOG_D
+        "Provisional calls from the first %d used cycles\n",                    // E_PROVISIONAL_D
+        "Model parameters held fixed from bundle for block %d\n",               // E_BUNDLEPARAM_D
+        "Parameters solved by conjugate gradient in %d iterations\n",           // E_SOLVER_ITER_D
+        "Conjugate gradient not converged in %d iterations; using Cholesky\n",  // E_SOLVER_FALLBACK_D
         "",                                                                     // E_END_D
         "Using %d thread(s) (%d requested)\n",                                  // E_THREAD_DD
         "Input file contains fewer cycles than requested; %d instead of %d\n",  // E_CYCLESIZE_DD
         "Tile data size: %d clusters of %d cycles\n",                           // E_TILESIZE_DD
         "Failed to initialise model for block %d, %d cycles\n",                 // E_INIT_FAIL_DD
         "Processing block %d, %d cycles\n",                                     // E_PROCESS_DD
+        "Estimating lane %d parameters from %d sampled clusters\n",             // E_LANEFIT_DD
+        "Thin to %d clusters for parameter estimation; random seed %d\n",       // E_THINTARGET_DD
+        "Using %d worker processes of %d thread(s) each\n",                     // E_WORKER_DD
+        "Worker %d ended abnormally; wait status %d\n",                         // E_WORKER_FAIL_DD
+        "Waiting for cycle %d; %d used cycles stored\n",                        // E_CYCLE_WAIT_DD
+        "Cluster range selected: %d to %d\n",                                   // E_CLUSTER_RANGE_DD
         "",                                                                     // E_END_DD
         "%d clusters out of %d used for parameter estimation (%0.2F%%)\n",      // E_THIN_DDF
         "",                                                                     // E_END_DDF
+        "PCG parameter solves %d, iterations %d, fallbacks %d (%0.2F%%)\n",     // E_SOLVER_DDDF
+        "",                                                                     // E_END_DDDF
 
         "%s %20s\n",                                                            // E_GENERIC_SS
         "%s %d\n",                                                              // E_GENERIC_SD
@@ -480,6 +504,10 @@ int main ( int argc, char * argv[]){
         for (MSGTYPE typi = E_END_DD + 1; typi < E_END_DDF; typi++) {
             message(typi, sev, INT1, INT2, FLOAT1);
         }
+        sev = (sev + 1) % MSG_NUM;
+        for (MSGTYPE typi = E_END_DDF + 1; typi < E_END_DDDF; typi++) {
+            message(typi, sev, INT1, INT2, INT1, FLOAT1);
+        }
     }
     
     tidyup_message();
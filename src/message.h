@@ -55,6 +55,13 @@ typedef enum MsgTypeT {E_DEFAULTBLOCK,
                        E_MATRIX_FAIL_S,
                        E_NOCREATE_S,
                        E_ZERO_LAMBDA_S,
+                       E_JOB_START_S,
+                       E_TILE_COMPLETE_S,
+                       E_CHECKPOINT_FAIL_S,
+                       E_CHECKPOINT_BAD_S,
+                       E_BAD_BUNDLE_S,
+                       E_BUNDLE_FAIL_S,
+                       E_NOCLUSTER_S,
                        E_END_S,
                        E_INPUT_DIR_SS,
                        E_INPUT_FOUND_SS,
@@ -68,12 +75,15 @@ typedef enum MsgTypeT {E_DEFAULTBLOCK,
                        E_OPT_SELECT_SS,
                        E_BAD_TXT_SS,
                        E_BAD_NUM_SS,
+                       E_JOB_END_SS,
                        E_END_SS,
                        E_BAD_CHAR_SC,
                        E_END_SC,
                        E_PATTERN_MATCH_SD,
                        E_OPT_SELECT_SD,
                        E_BAD_CLUSTER_SD,
+                       E_WARMSTART_SD,
+                       E_CHECKPOINT_RESUME_SD,
                        E_END_SD,
                        E_MATRIXINIT_SDD,
                        E_END_SDD,
@@ -84,15 +94,29 @@ typedef enum MsgTypeT {E_DEFAULTBLOCK,
                        E_ZEROTHIN_D,
                        E_PROCESS_FAIL_D,
                        E_CYCLESIZE_D,
+                       E_LANEPARAM_D,
+                       E_WORKER_LOG_D,
+                       E_PROVISIONAL_D,
+                       E_BUNDLEPARAM_D,
+                       E_SOLVER_ITER_D,
+                       E_SOLVER_FALLBACK_D,
                        E_END_D,
                        E_THREAD_DD,
                        E_CYCLESIZE_DD,
                        E_TILESIZE_DD,
                        E_INIT_FAIL_DD,
                        E_PROCESS_DD,
+                       E_LANEFIT_DD,
+                       E_THINTARGET_DD,
+                       E_WORKER_DD,
+                       E_WORKER_FAIL_DD,
+                       E_CYCLE_WAIT_DD,
+                       E_CLUSTER_RANGE_DD,
                        E_END_DD,
                        E_THIN_DDF,    
                        E_END_DDF,
+                       E_SOLVER_DDDF,
+                       E_END_DDDF,
                        E_GENERIC_SS,
                        E_GENERIC_SD,
                        E_GENERIC_SU,
@@ -68,6 +68,9 @@ MAT calculateWe( const MAT lssi, const bool * allowed, MAT we){
 
     real_t meanLSSi = mean(lssi->x,allowed,ncluster);
     real_t varLSSi = variance(lssi->x,allowed,ncluster);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for ( uint_fast32_t cl=0 ; cl<ncluster ; cl++){
         if(!allowed[cl]){ continue; }
         const real_t d = lssi->x[cl]-meanLSSi;
@@ -128,7 +131,7 @@ MAT calculateSbar( const MAT lambda, const MAT we, const ARRAY(NUC) bases, const
     for ( uint_fast32_t cl=0 ; cl<ncluster ; cl++){
         if(!allowed[cl]){ continue; }
         for ( uint_fast32_t cy=0 ; cy<ncycle ; cy++){
-            int base = bases.elt[cl*ncycle+cy];
+            int base = bases.elt[(size_t)cl*ncycle+cy];
             if(!isambig(base)){
                 Sbar->x[cy*NBASE+base] += we->x[cl] * lambda->x[cl];
             }
@@ -167,11 +170,11 @@ MAT calculateJ( const MAT lambda, const MAT we, const ARRAY(NUC) bases, const ui
     for ( uint_fast32_t cl=0 ; cl<ncluster ; cl++){
         const real_t welam = we->x[cl] * lambda->x[cl] * lambda->x[cl];
         for ( uint_fast32_t cy=0 ; cy<ncycle ; cy++){
-            const uint_fast32_t base = bases.elt[cl*ncycle+cy];
+            const uint_fast32_t base = bases.elt[(size_t)cl*ncycle+cy];
             if(!isambig(base)){
                 const uint_fast32_t offset = cy*ncycle*NBASE*NBASE + base*NBASE;
                 for ( uint_fast32_t cy2=0 ; cy2<ncycle ; cy2++){
-                    const uint_fast32_t base2 = bases.elt[cl*ncycle+cy2];
+                    const uint_fast32_t base2 = bases.elt[(size_t)cl*ncycle+cy2];
                     if(!isambig(base2)){
                         J->x[offset+cy2*lda+base2] += welam;
                     }
@@ -231,7 +234,7 @@ MAT calculateK( const MAT lambda, const MAT we, const ARRAY(NUC) bases, const TI
 
     node = tile->clusterlist;
     while (NULL != node && cl < ncluster){
-        const bool has_ambig = has_ambiguous_base(bases.elt+cl*ncycle, ncycle);
+        const bool has_ambig = has_ambiguous_base(bases.elt+(size_t)cl*ncycle, ncycle);
         const real_t welam = we->x[cl] * lambda->x[cl];
         for ( uint_fast32_t i=0 ; i<(NBASE*ncycle) ; i++){
            tmp[i] = welam * node->elt->signals->xint[i];
@@ -240,7 +243,7 @@ MAT calculateK( const MAT lambda, const MAT we, const ARRAY(NUC) bases, const TI
             for ( uint_fast32_t cy=0 ; cy<ncycle ; cy++){
                 const uint_fast32_t ioffset = cy*NBASE;
                 for ( uint_fast32_t cy2=0 ; cy2<ncycle ; cy2++){
-                    const uint_fast32_t base = bases.elt[cl*ncycle+cy2];
+                    const uint_fast32_t base = bases.elt[(size_t)cl*ncycle+cy2];
                     if(!isambig(base)){
                         const uint_fast32_t koffset = cy*lda*ncycle + cy2*lda + base;
                         for ( uint_fast32_t ch=0 ; ch<NBASE ; ch++){
@@ -254,7 +257,7 @@ MAT calculateK( const MAT lambda, const MAT we, const ARRAY(NUC) bases, const TI
             for ( uint_fast32_t cy=0 ; cy<ncycle ; cy++){
                 const uint_fast32_t ioffset = cy*NBASE;
                 for ( uint_fast32_t cy2=0 ; cy2<ncycle ; cy2++){
-                    const uint_fast32_t base = bases.elt[cl*ncycle+cy2];
+                    const uint_fast32_t base = bases.elt[(size_t)cl*ncycle+cy2];
                     const uint_fast32_t koffset = cy*lda*ncycle + cy2*lda + base;
                     for ( uint_fast32_t ch=0 ; ch<NBASE ; ch++){
                         K->x[ koffset + ch*NBASE] += tmp[ioffset + ch];
@@ -462,18 +465,41 @@ MAT calculatePrhs( const MAT Ibar, const MAT Mt, const MAT Sbar, const MAT N, co
     return rhs;
 }
 
+/**
+ * Zero the per-thread accumulation matrices, allocating any that do not yet exist.
+ * Returns false if memory allocation fails.
+ */
+static bool prepare_parts(MAT * part, const int ncpu, const uint_fast32_t lda){
+    for ( int i=0 ; i<ncpu ; i++) {
+        if (NULL==part[i]) {
+            part[i] = new_MAT(lda,lda);
+            if (NULL==part[i]) { return false; }
+        }
+        else {
+            if (part[i]->nrow!=lda || part[i]->ncol!=lda) { return false; }
+            memset(part[i]->x, 0, lda*lda*sizeof(real_t));
+        }
+    }
+    return true;
+}
+
 /**
  * Calculates matrix J used in calculateLhs.
  * J is the matrix \\sum_i we_i lambda_i lambda_i Vec(S_i) Vec(S_i)^t.
+ * - part:     Array of omp_get_max_threads() (lda x lda) matrices for per-thread accumulation,
+ *             kept by the caller for reuse. Entries may be NULL and are then allocated.
+ *             If part is NULL then temporary matrices are used.
+ * A supplied newJ is not freed if the calculation fails.
  */
-MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const int ncycle, const bool * allowed, MAT newJ){
+MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const int ncycle, const bool * allowed, MAT * part, MAT newJ){
     if(NULL==lambda || NULL==bases.elt || NULL==we || NULL==allowed){ return NULL;}
 
     const uint_fast32_t lda = ncycle * NBASE;
     const uint_fast32_t ncluster = we->nrow;
 
     // Allocate memory if necessary and initialise to zero
-    if(NULL==newJ){
+    const bool newmat = (NULL==newJ);
+    if(newmat){
         newJ = new_MAT(lda,lda);
         if(NULL==newJ){ return NULL; }
     }
@@ -485,14 +511,14 @@ MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const
     uint_fast32_t i, j, idx1, idx2, base, base2;
     int th_id;                              // thread number
     const int ncpu = omp_get_max_threads();
-    MAT J[ncpu];
-    for ( int i=0 ; i<ncpu ; i++) {
-        J[i] = NULL;
-    }
-    for ( int i=0 ; i<ncpu ; i++) {
-        J[i] = new_MAT(lda,lda);
-        if (NULL==J[i]) { goto cleanup; }
+    MAT tmpJ[ncpu];
+    MAT * J = (NULL==part) ? tmpJ : part;
+    if (NULL==part) {
+        for ( int i=0 ; i<ncpu ; i++) {
+            tmpJ[i] = NULL;
+        }
     }
+    if (!prepare_parts(J, ncpu, lda)) { goto cleanup; }
     
 #ifdef _OPENMP
     // multi-threaded loop
@@ -505,11 +531,11 @@ MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const
         th_id = omp_get_thread_num();
         eltmult = we->x[cl] * lambda->x[cl] * lambda->x[cl];
         for ( i=0 ; i<ncycle ; i++){
-            base = bases.elt[cl*ncycle+i];
+            base = bases.elt[(size_t)cl*ncycle+i];
             if (!isambig(base)){
                 idx1 = i*NBASE+base;
                 for ( j=0 ; j<ncycle ; j++){
-                    base2 = bases.elt[cl*ncycle+j];
+                    base2 = bases.elt[(size_t)cl*ncycle+j];
                     if (!isambig(base2)){
                         idx2 = j*NBASE+base2;
                         J[th_id]->x[idx1*lda+idx2] += eltmult;
@@ -521,10 +547,10 @@ MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const
 
     // Accumulate from multi-thread 
     for ( int i=0 ; i<ncpu ; i++){
-        if (NULL!=J[i]){
-            for ( int j=0 ; j<lda*lda ; j++){
-                newJ->x[j] += J[i]->x[j];
-            }
+        for ( int j=0 ; j<lda*lda ; j++){
+            newJ->x[j] += J[i]->x[j];
+        }
+        if (NULL==part) {
             free_MAT(J[i]);
         }
     }
@@ -532,10 +558,14 @@ MAT calculateNewJ(const MAT lambda, const ARRAY(NUC) bases, const MAT we, const
     return newJ;
     
 cleanup:
-    for ( int i=0 ; i<ncpu ; i++) {
-        free_MAT(J[i]);
+    if (NULL==part) {
+        for ( int i=0 ; i<ncpu ; i++) {
+            free_MAT(tmpJ[i]);
+        }
+    }
+    if (newmat) {
+        free_MAT(newJ);
     }
-    free_MAT(newJ);
     return NULL;    
 }
 
@@ -543,15 +573,18 @@ cleanup:
  * Calculates matrix K used in calculateRhs.
  * K is the matrix \\sum_i we_i lambda_i Vec(S_i) Vec(I_i)^t.
  * First calculate its transpose (better memory layout).
+ * - part:     Per-thread accumulation matrices as for calculateNewJ.
+ * A supplied newK is not freed if the calculation fails.
  */
-MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, const MAT we, const int ncycle, const bool * allowed, MAT newK){
+MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, const MAT we, const int ncycle, const bool * allowed, MAT * part, MAT newK){
     if(NULL==lambda || NULL==bases.elt || NULL==tile || NULL==we || NULL==allowed){ return NULL;}
 
     const uint_fast32_t lda = ncycle * NBASE;
-    unsigned int ncluster = tile->ncluster;
+    size_t ncluster = tile->ncluster;
 
     // Allocate memory if necessary and initialise to zero
-    if(NULL==newK){
+    const bool newmat = (NULL==newK);
+    if(newmat){
         newK = new_MAT(lda,lda);
         if(NULL==newK){ return NULL; }
     }
@@ -565,14 +598,14 @@ MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, con
     real_t colmult;
     int th_id;                              // thread number
     const int ncpu = omp_get_max_threads();
-    MAT K[ncpu];
-    for ( int i=0 ; i<ncpu ; i++) {
-        K[i] = NULL;
-    }
-    for ( int i=0 ; i<ncpu ; i++) {
-        K[i] = new_MAT(lda,lda);
-        if (NULL==K[i]) { goto cleanup; }
+    MAT tmpK[ncpu];
+    MAT * K = (NULL==part) ? tmpK : part;
+    if (NULL==part) {
+        for ( int i=0 ; i<ncpu ; i++) {
+            tmpK[i] = NULL;
+        }
     }
+    if (!prepare_parts(K, ncpu, lda)) { goto cleanup; }
 
     // make an array of list pointers for multi-threading
     nodearry = array_from_LIST(CLUSTER)(tile->clusterlist, &ncluster);
@@ -589,7 +622,7 @@ MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, con
         if(!allowed[cl]){ continue;}
         th_id = omp_get_thread_num();
         for ( i=0 ; i<ncycle ; i++){
-            base = bases.elt[cl*ncycle+i];
+            base = bases.elt[(size_t)cl*ncycle+i];
             if(!isambig(base)){
                 col = i*NBASE + base;
                 colmult = we->x[cl] * lambda->x[cl];
@@ -604,10 +637,10 @@ MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, con
     
     // Accumulate from multi-thread 
     for ( int i=0 ; i<ncpu ; i++){
-        if (NULL!=K[i]){
-            for ( int j=0 ; j<lda*lda ; j++){
-                newK->x[j] += K[i]->x[j];
-            }
+        for ( int j=0 ; j<lda*lda ; j++){
+            newK->x[j] += K[i]->x[j];
+        }
+        if (NULL==part) {
             free_MAT(K[i]);
         }
     }
@@ -619,10 +652,14 @@ MAT calculateNewK(const MAT lambda, const ARRAY(NUC) bases, const TILE tile, con
 
 cleanup:
     free_array_LIST(CLUSTER)(nodearry);
-    for ( int i=0 ; i<ncpu ; i++) {
-        free_MAT(K[i]);
+    if (NULL==part) {
+        for ( int i=0 ; i<ncpu ; i++) {
+            free_MAT(tmpK[i]);
+        }
+    }
+    if (newmat) {
+        free_MAT(newK);
     }
-    free_MAT(newK);
     return NULL;    
 }
 
@@ -717,6 +754,166 @@ int solverChol( MAT lhs, MAT rhs, real_t * null, const real_t delta_diag){
     return info;
 }
 
+/**
+ * Cholesky factor in place of the diagonal blocks of size NBASE of a symmetric matrix,
+ * the last block being any remainder; used as a block-Jacobi preconditioner.
+ * Factor of each block stored lower triangle, column-major, in NBASE*NBASE elements of fac.
+ * Returns false if a block is not positive-definite.
+ */
+static bool factor_diag_blocks(const MAT lhs, const real_t delta_diag, real_t * fac){
+    const int N = lhs->nrow;
+    for ( int b=0 ; b<N ; b+=NBASE){
+        const int bs = (N-b<NBASE) ? N-b : NBASE;
+        real_t * L = fac + b*NBASE;
+        for ( int j=0 ; j<bs ; j++){
+            for ( int i=j ; i<bs ; i++){
+                real_t v = lhs->x[(b+j)*N+b+i] + ((i==j) ? delta_diag : 0.0);
+                for ( int k=0 ; k<j ; k++){
+                    v -= L[k*NBASE+i] * L[k*NBASE+j];
+                }
+                if(i==j){
+                    if(!(v>0.0)){ return false; }
+                    L[j*NBASE+j] = sqrt(v);
+                }
+                else {
+                    L[j*NBASE+i] = v / L[j*NBASE+j];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/** Apply the block-Jacobi preconditioner to one column: z = M^{-1} r. */
+static void apply_diag_blocks(const real_t * fac, const int N, const real_t * r, real_t * z){
+    for ( int b=0 ; b<N ; b+=NBASE){
+        const int bs = (N-b<NBASE) ? N-b : NBASE;
+        const real_t * L = fac + b*NBASE;
+        // L y = r
+        for ( int i=0 ; i<bs ; i++){
+            real_t v = r[b+i];
+            for ( int k=0 ; k<i ; k++){ v -= L[k*NBASE+i] * z[b+k]; }
+            z[b+i] = v / L[i*NBASE+i];
+        }
+        // L^t z = y
+        for ( int i=bs-1 ; i>=0 ; i--){
+            real_t v = z[b+i];
+            for ( int k=i+1 ; k<bs ; k++){ v -= L[i*NBASE+k] * z[b+k]; }
+            z[b+i] = v / L[i*NBASE+i];
+        }
+    }
+}
+
+/** Dot product of two columns. */
+static real_t dot_column(const real_t * x, const real_t * y, const int n){
+    real_t res = 0.0;
+    for ( int i=0 ; i<n ; i++){
+        res += x[i] * y[i];
+    }
+    return res;
+}
+
+/**
+ * Solve system of linear equations by preconditioned conjugate gradient, each column of rhs
+ * separately, starting from x0. The preconditioner is the Cholesky factor of the diagonal
+ * NBASE x NBASE blocks, one per cycle of the parameter problems being considered.
+ * Assumes that lhs is symmetric positive-definite, with delta_diag added to the diagonal.
+ * lhs is not changed. Iterates until the residual of every column is at most tol times
+ * the norm of its rhs, or maxiter iterations have been done.
+ * Result is stored in rhs if converged, otherwise rhs is unchanged so the system can be
+ * solved another way.
+ * Returns the number of iterations if converged, -1 if not converged or no memory.
+ */
+int solverPCG(const MAT lhs, MAT rhs, const MAT x0, const real_t delta_diag, const real_t tol, const int maxiter){
+    validate(NULL!=lhs,-1);
+    validate(NULL!=rhs,-1);
+    validate(NULL!=x0,-1);
+    validate(lhs->nrow==lhs->ncol,-1);
+    validate(lhs->ncol==rhs->nrow,-1);
+    validate((x0->nrow==rhs->nrow) && (x0->ncol==rhs->ncol),-1);
+    const int N = lhs->nrow;
+    const int ncol = rhs->ncol;
+    const size_t nelt = (size_t)N * ncol;
+    const real_t one = 1.0, zero = 0.0, minus_one = -1.0;
+    int ret = -1;
+
+    real_t * work = malloc((4*nelt + N*NBASE + 3*ncol) * sizeof(real_t));
+    if(NULL==work){ return -1; }
+    real_t * X = work;
+    real_t * R = X + nelt;
+    real_t * P = R + nelt;
+    real_t * Q = P + nelt;
+    real_t * fac = Q + nelt;
+    real_t * rz = fac + N*NBASE;
+    real_t * tol2 = rz + ncol;
+    real_t * rr = tol2 + ncol;
+    if(!factor_diag_blocks(lhs,delta_diag,fac)){ goto cleanup; }
+
+    // residual R = rhs - (lhs + delta I) X
+    memcpy(X, x0->x, nelt * sizeof(real_t));
+    memcpy(R, rhs->x, nelt * sizeof(real_t));
+    gemm(LAPACK_NOTRANS,LAPACK_NOTRANS,&N,&ncol,&N,&minus_one,lhs->x,&N,X,&N,&one,R,&N);
+    int nconv = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:nconv)
+#endif
+    for ( int j=0 ; j<ncol ; j++){
+        real_t * rj = R + (size_t)j*N;
+        for ( int i=0 ; i<N ; i++){ rj[i] -= delta_diag * X[(size_t)j*N+i]; }
+        const real_t bnorm = sqrt(dot_column(rhs->x+(size_t)j*N, rhs->x+(size_t)j*N, N));
+        tol2[j] = (tol*bnorm) * (tol*bnorm);
+        rr[j] = dot_column(rj,rj,N);
+        apply_diag_blocks(fac,N,rj,P+(size_t)j*N);
+        rz[j] = dot_column(rj,P+(size_t)j*N,N);
+        nconv += (rr[j]<=tol2[j]);
+    }
+
+    int iter = 0;
+    while(nconv<ncol){
+        if(iter==maxiter){ goto cleanup; }
+        iter++;
+
+        // Q = (lhs + delta I) P; converged columns take no further steps
+        gemm(LAPACK_NOTRANS,LAPACK_NOTRANS,&N,&ncol,&N,&one,lhs->x,&N,P,&N,&zero,Q,&N);
+        nconv = 0;
+        bool breakdown = false;
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(+:nconv) reduction(||:breakdown)
+#endif
+        for ( int j=0 ; j<ncol ; j++){
+            if(rr[j]<=tol2[j]){ nconv++; continue; }
+            real_t * xj = X + (size_t)j*N;
+            real_t * rj = R + (size_t)j*N;
+            real_t * pj = P + (size_t)j*N;
+            real_t * qj = Q + (size_t)j*N;
+            for ( int i=0 ; i<N ; i++){ qj[i] += delta_diag * pj[i]; }
+            const real_t pq = dot_column(pj,qj,N);
+            if(!(pq>0.0)){ breakdown = true; continue; }
+            const real_t alpha = rz[j] / pq;
+            for ( int i=0 ; i<N ; i++){
+                xj[i] += alpha * pj[i];
+                rj[i] -= alpha * qj[i];
+            }
+            rr[j] = dot_column(rj,rj,N);
+            if(rr[j]<=tol2[j]){ nconv++; continue; }
+            // Q column no longer needed, holds preconditioned residual
+            apply_diag_blocks(fac,N,rj,qj);
+            const real_t rznew = dot_column(rj,qj,N);
+            const real_t beta = rznew / rz[j];
+            rz[j] = rznew;
+            for ( int i=0 ; i<N ; i++){ pj[i] = qj[i] + beta * pj[i]; }
+        }
+        if(breakdown){ goto cleanup; }
+    }
+
+    memcpy(rhs->x, X, nelt * sizeof(real_t));
+    ret = iter;
+
+cleanup:
+    free(work);
+    return ret;
+}
+
 /** 
  * Solve system of linear equations using SVD.
  * Wrapper for LAPACK routine.
@@ -1054,6 +1251,19 @@ int main ( void){
     xfprintf(xstdout,"P zero solution matrix (info=%d):\n",retP);
     show_MAT(xstdout,Prhs_copy,0,0);
 
+    /* conjugate gradient from zero, against Cholesky */
+    Prhs_copy = copyinto_MAT(Prhs_copy, Prhs);
+    MAT Px0 = new_MAT(Prhs->nrow, Prhs->ncol);
+    retP = solverPCG(Plhs, Prhs_copy, Px0, 0.0, 1e-10, 100);
+    xfprintf(xstdout,"P conjugate gradient solution matrix (converged=%s):\n",(retP<0)?"no":"yes");
+    show_MAT(xstdout,Prhs_copy,0,0);
+
+    Plhs_copy = copyinto_MAT(Plhs_copy, Plhs);
+    MAT Pchol = copy_MAT(Prhs);
+    retP = solverChol(Plhs_copy, Pchol, tmp, 0.0);
+    xfprintf(xstdout,"P cholesky solution matrix (info=%d):\n",retP);
+    show_MAT(xstdout,Pchol,0,0);
+
 #ifdef FORTRAN
     /* NNLS */
     Plhs_copy = copyinto_MAT(Plhs_copy, Plhs);
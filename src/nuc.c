@@ -258,7 +258,7 @@ int main ( int argc, char * argv[]){
     free_ARRAY(NUC)(nucs);
 
     nucs = nucs_from_string(argv[1]);
-    xfprintf(xstdout, "Stored length            : %u\n", nucs.nelt);
+    xfprintf(xstdout, "Stored length            : %zu\n", nucs.nelt);
     xfputs("Store/write sequence     : ", xstdout);
     for (uint_fast32_t i = 0; i < nucs.nelt; i++){
         show_NUC(xstdout, nucs.elt[i]);
@@ -46,8 +46,19 @@ static const char *MESS_TEXT[] = {"Intercept",
                                   "Next base adjustment", 
                                   "Triplet base adjustment"};
 
+/** Number of base contexts, the bases and ambiguous. */
+#define NCONTEXT (NBASE + 1)
+/** Number of entries in the fused adjustment tables, (prior, base, next) contexts. */
+#define NFUSED (NCONTEXT * NCONTEXT * NCONTEXT)
+
 /* members */
 
+/**
+ * Adjustments of the calibration table fused by (prior, base, next) context, including ambiguous
+ * bases, with zero where an adjustment does not apply. Kept as three terms added in the order of
+ * adjust_quality so fused and unfused adjustments are bit-identical; built by read_quality_table.
+ */
+static real_t FusedPrior[NFUSED], FusedNext[NFUSED], FusedTriplet[NFUSED];
 static bool NewQTable = false;                  ///< Indicates a quality calibration table has been read in.
 static bool QualOut = true;                     ///< Unset to turn off quality calibration table output.
 
@@ -115,6 +126,38 @@ static void show_array_byrow (XFILE * fp, real_t *values, const int nrow, const
 }
 
 
+/** Index of a (prior, base, next) context in the fused adjustment tables. */
+static inline int fused_index(const NUC prior, const NUC base, const NUC next) {
+    return (prior * NCONTEXT + base) * NCONTEXT + next;
+}
+
+/** Fill the fused adjustment tables from the current calibration table. */
+static void fuse_quality_table(void) {
+
+    for (NUC prior = 0; prior < NCONTEXT; prior++) {
+        for (NUC base = 0; base < NCONTEXT; base++) {
+            for (NUC next = 0; next < NCONTEXT; next++) {
+                const int i = fused_index(prior, base, next);
+                FusedPrior[i] = 0.0;
+                FusedNext[i] = 0.0;
+                FusedTriplet[i] = 0.0;
+                if (isambig(base)) {continue;}
+
+                if (!isambig(prior)) {
+                    FusedPrior[i] = QTable->prior[prior * NBASE + base];
+                }
+                if (!isambig(next)) {
+                    FusedNext[i] = QTable->next[next * NBASE + base];
+                }
+                if (!isambig(next) && !isambig(prior)) {
+                    FusedTriplet[i] = QTable->triplet[(next * NBASE + prior) * NBASE + base];
+                }
+            }
+        }
+    }
+}
+
+
 /* public functions */
 
 QUALTAB free_qualtab(QUALTAB qtab){
@@ -170,25 +213,52 @@ void show_qualtab(XFILE * fp, const QUALTAB qtab) {
 
 /**
  * Adjust quality score for base using a linear calibration and neighbours.
- * Vectors used are defined in calibration table, from default or optionally read in.
+ * Vectors used are defined in calibration table, from default or optionally read in,
+ * and looked up in the fused tables made by read_quality_table.
  * First and last bases of a read are special cases, dealt with by setting the
  * prior or next base (respectively) to be NUC_AMBIG.
  */
 real_t adjust_quality(const real_t qual, const NUC prior, const NUC base, const NUC next){
 
     if(isambig(base)){ return MIN_QUALITY; }
+    const int i = fused_index(prior, base, next);
     real_t new_qual = QTable->intcept + QTable->slope * qual;
+    new_qual += FusedPrior[i];
+    new_qual += FusedNext[i];
+    new_qual += FusedTriplet[i];
+    return new_qual;
+}
 
-    if(!isambig(prior)){
-        new_qual += QTable->prior[prior*NBASE+base];
+/**
+ * Adjust the quality scores of a read in place, as adjust_quality for each base
+ * with the first and last bases special cases.
+ * Contexts of the whole read are indexed first so the adjustment is a straight pass over the read.
+ */
+void adjust_qualities(const uint_fast32_t ncycle, const NUC * base, real_t * restrict qual){
+
+    if (ncycle == 0) {return;}
+    if (ncycle == 1) {
+        qual[0] = adjust_quality(qual[0], NUC_AMBIG, base[0], NUC_AMBIG);
+        return;
     }
-    if(!isambig(next)){
-        new_qual += QTable->next[next*NBASE+base];
+
+    int context[ncycle];
+    context[0] = fused_index(NUC_AMBIG, base[0], base[1]);
+    for (uint_fast32_t cy = 1; cy < ncycle - 1; cy++) {
+        context[cy] = fused_index(base[cy - 1], base[cy], base[cy + 1]);
     }
-    if(!isambig(next) && !isambig(prior)){
-        new_qual += QTable->triplet[(next*NBASE+prior)*NBASE+base];
+    context[ncycle - 1] = fused_index(base[ncycle - 2], base[ncycle - 1], NUC_AMBIG);
+
+    const real_t intcept = QTable->intcept;
+    const real_t slope = QTable->slope;
+    for (uint_fast32_t cy = 0; cy < ncycle; cy++) {
+        const int i = context[cy];
+        real_t new_qual = intcept + slope * qual[cy];
+        new_qual += FusedPrior[i];
+        new_qual += FusedNext[i];
+        new_qual += FusedTriplet[i];
+        qual[cy] = isambig(base[cy]) ? MIN_QUALITY : new_qual;
     }
-    return new_qual;
 }
 
 /**
@@ -223,7 +293,8 @@ void output_quality_table(void) {
 }
 
 /**
- * Read in quality calibration table if supplied and use to replace the default values.
+ * Read in quality calibration table if supplied and use to replace the default values,
+ * then make the fused adjustment tables from the table in use.
  * Returns false if file supplied but failed to read.
  */
 bool read_quality_table(void) {
@@ -264,6 +335,7 @@ bool read_quality_table(void) {
         xfclose(fp);
     }
 
+    fuse_quality_table();
     return true;
 
  cleanup:
@@ -47,15 +47,7 @@ QUALTAB new_qualtab(void);
 void show_qualtab(XFILE * fp, const QUALTAB qtab);
 
 real_t adjust_quality(const real_t qual, const NUC prior, const NUC base, const NUC next);
-
-/**  Adjust quality score for first base by setting prior to NUC_AMBIG. */
-static inline real_t adjust_first_quality(const real_t qual, const NUC base, const NUC next){
-    return adjust_quality(qual, NUC_AMBIG, base, next);
-}
-/**  Adjust quality score for last base by setting next to NUC_AMBIG. */
-static inline real_t adjust_last_quality(const real_t qual, const NUC prior, const NUC base){
-    return adjust_quality(qual, prior, base, NUC_AMBIG);
-}
+void adjust_qualities(const uint_fast32_t ncycle, const NUC * base, real_t * restrict qual);
 
 void output_quality_table(void);
 bool read_quality_table(void);
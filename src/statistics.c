@@ -28,23 +28,25 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include "aybthread.h"
 #include "statistics.h"
 
 
-real_t sum( const real_t * x, const bool * allowed, const uint_fast32_t n){
-    if(NULL==x){return NAN;}
-    
-    real_t sum = 0.0;
-    real_t c = 0.;
-    for ( uint_fast32_t i=0; i<n ; i++){
-        if(NULL!=allowed && !allowed[i]){ continue; }
-        volatile real_t y = x[i] - c;
-        volatile real_t t = sum + y;
-        c = (t-sum) - y;
-        sum = t;
-    }
-    return sum;
-}
+/* constants */
+
+/**
+ * Values in each block of a reduction or selection pass. Blocks are processed in parallel and
+ * combined in block order, so results do not depend on the number of threads.
+ */
+static const uint_fast32_t STAT_BLOCK = 4096;
+#define STAT_LANE 4                             ///< Independent compensated sums in a block, one per SIMD lane.
+static const uint_fast32_t SELECT_SERIAL = 32768;   ///< Ranges selected serially once no longer.
+
+/** Terms of a compensated reduction. */
+typedef enum StatTermT {TERM_X, TERM_XX, TERM_XY, TERM_DEV2} STATTERM;
+
+
+/* private functions */
 
 int cmpReal(const void * x, const void * y){
    if( *(real_t*)(x) == *(real_t*)(y) ){ return 0;}
@@ -55,48 +57,327 @@ bool isodd(const uint_fast32_t n){
    return n%2;
 }
 
-// Median by sorting.
-// Divide and conquer would be quicker (linear vs n log(n) )
+/** Value of a term of a reduction, for element i. */
+static inline real_t stat_term(const STATTERM kind, const real_t * x, const real_t * y, const real_t m, const uint_fast32_t i){
+    switch(kind){
+        case TERM_XX:   return x[i]*x[i];
+        case TERM_XY:   return x[i]*y[i];
+        case TERM_DEV2: return (x[i]-m)*(x[i]-m);
+        default:        return x[i];
+    }
+}
+
+/**
+ * Add a value to a sum and accumulate the rounding error separately (Neumaier).
+ * Used to combine partial sums, which may be of any relative size.
+ */
+static inline void add_compensated(real_t * sum, real_t * err, const real_t v){
+    const real_t t = *sum + v;
+    if(fabs(*sum)>=fabs(v)){ *err += (*sum-t) + v; }
+    else { *err += (v-t) + *sum; }
+    *sum = t;
+}
+
+/**
+ * Compensated (Kahan) sum of the terms of one block, in STAT_LANE independent lanes
+ * that the compiler can keep in one SIMD register; terms not allowed contribute zero.
+ * Lanes are combined into sum and error. Returns the number of allowed terms.
+ * Without -ffast-math the compensation is not reassociated away, so needs no volatile.
+ */
+static uint_fast32_t block_sum(const STATTERM kind, const real_t * x, const real_t * y, const real_t m, const bool * allowed,
+                               const uint_fast32_t start, const uint_fast32_t end, real_t * sum, real_t * err){
+    real_t s[STAT_LANE] = {0.}, c[STAT_LANE] = {0.};
+    uint_fast32_t count = 0;
+    uint_fast32_t i = start;
+    for ( ; i+STAT_LANE<=end ; i+=STAT_LANE){
+        for ( int l=0 ; l<STAT_LANE ; l++){
+            const bool use = (NULL==allowed) || allowed[i+l];
+            const real_t v = (use ? stat_term(kind,x,y,m,i+l) : 0.) - c[l];
+            const real_t t = s[l] + v;
+            c[l] = (t-s[l]) - v;
+            s[l] = t;
+            count += use;
+        }
+    }
+    for ( ; i<end ; i++){
+        if(NULL!=allowed && !allowed[i]){ continue; }
+        const real_t v = stat_term(kind,x,y,m,i) - c[0];
+        const real_t t = s[0] + v;
+        c[0] = (t-s[0]) - v;
+        s[0] = t;
+        count++;
+    }
+
+    *sum = 0.;
+    *err = 0.;
+    for ( int l=0 ; l<STAT_LANE ; l++){
+        add_compensated(sum,err,s[l]);
+        *err -= c[l];
+    }
+    return count;
+}
+
+/**
+ * Compensated sum of the allowed terms of x, blocks summed in parallel.
+ * Number of allowed terms returned in nallowed if not null.
+ */
+static real_t reduce_terms(const STATTERM kind, const real_t * x, const real_t * y, const real_t m, const bool * allowed,
+                           const uint_fast32_t n, uint_fast32_t * nallowed){
+    const uint_fast32_t nblock = (n + STAT_BLOCK - 1) / STAT_BLOCK;
+    real_t * part = (nblock>1) ? malloc(2*nblock*sizeof(real_t)) : NULL;
+    uint_fast32_t * count = (NULL!=part) ? malloc(nblock*sizeof(uint_fast32_t)) : NULL;
+    real_t sum, err;
+    uint_fast32_t nterm;
+
+    if(NULL==count){
+        /* single block, or no memory for partial sums */
+        nterm = block_sum(kind,x,y,m,allowed,0,n,&sum,&err);
+    }
+    else {
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            const uint_fast32_t end = (b+1<nblock) ? (b+1)*STAT_BLOCK : n;
+            count[b] = block_sum(kind,x,y,m,allowed,b*STAT_BLOCK,end,part+2*b,part+2*b+1);
+        }
+        sum = 0.; err = 0.; nterm = 0;
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            add_compensated(&sum,&err,part[2*b]);
+            err += part[2*b+1];
+            nterm += count[b];
+        }
+    }
+    free(count);
+    free(part);
+
+    if(NULL!=nallowed){ *nallowed = nterm; }
+    return sum + err;
+}
+
+/** Swap two values. */
+static inline void swap_real(real_t * a, real_t * b){
+    const real_t t = *a; *a = *b; *b = t;
+}
+
+/** Median of three values. */
+static inline real_t median3(const real_t a, const real_t b, const real_t c){
+    if(a<b){ return (b<c) ? b : ((a<c) ? c : a); }
+    return (a<c) ? a : ((b<c) ? c : b);
+}
+
+/** Pivot for selection, the median of three medians of three spread through the range (ninther). */
+static real_t select_pivot(const real_t * x, const uint_fast32_t n){
+    if(n<9){ return median3(x[0],x[n/2],x[n-1]); }
+    const uint_fast32_t d = n/8;
+    return median3(median3(x[0],x[d],x[2*d]),
+                   median3(x[n/2-d],x[n/2],x[n/2+d]),
+                   median3(x[n-1-2*d],x[n-1-d],x[n-1]));
+}
+
+/** Selection depth allowed before falling back to sorting; twice the log2 of n. */
+static unsigned int select_depth(uint_fast32_t n){
+    unsigned int depth = 2;
+    while(n>1){ n >>= 1; depth += 2; }
+    return depth;
+}
+
+/**
+ * Value of rank k (from zero) of x, selecting serially by three way partitioning.
+ * Elements of x are reordered. Sorts the range instead if partitioning makes too little progress.
+ */
+static real_t select_serial(real_t * x, uint_fast32_t n, uint_fast32_t k){
+    unsigned int depth = select_depth(n);
+    while(n>1){
+        if(0==depth--){
+            qsort(x,n,sizeof(real_t),cmpReal);
+            return x[k];
+        }
+        const real_t pivot = select_pivot(x,n);
+        uint_fast32_t lt = 0, i = 0, gt = n;
+        while(i<gt){
+            if(x[i]<pivot){ swap_real(x+lt,x+i); lt++; i++; }
+            else if(x[i]>pivot){ gt--; swap_real(x+i,x+gt); }
+            else { i++; }
+        }
+        if(k<lt){ n = lt; }
+        else if(k<gt){ return pivot; }
+        else { x += gt; k -= gt; n -= gt; }
+    }
+    return x[0];
+}
+
+/**
+ * Value of rank k (from zero) of the n values in x, using buf (also n long) as workspace.
+ * Long ranges are partitioned three ways in parallel, blocks placing their elements in block
+ * order, until the range containing rank k is short enough to select serially (introselect).
+ * Elements of x and buf are overwritten.
+ */
+static real_t select_parallel(real_t * x, real_t * buf, uint_fast32_t n, uint_fast32_t k){
+    const uint_fast32_t maxblock = (n + STAT_BLOCK - 1) / STAT_BLOCK;
+    uint_fast32_t * count = (maxblock>1) ? malloc(3*maxblock*sizeof(uint_fast32_t)) : NULL;
+    unsigned int depth = select_depth(n);
+    real_t ret = NAN;
+
+    while(n>SELECT_SERIAL && NULL!=count){
+        if(0==depth--){
+            qsort(x,n,sizeof(real_t),cmpReal);
+            ret = x[k];
+            goto cleanup;
+        }
+        const real_t pivot = select_pivot(x,n);
+        const uint_fast32_t nblock = (n + STAT_BLOCK - 1) / STAT_BLOCK;
+
+        /* count values below, equal to and above pivot in each block */
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            const uint_fast32_t end = (b+1<nblock) ? (b+1)*STAT_BLOCK : n;
+            uint_fast32_t nlt = 0, ngt = 0;
+            for ( uint_fast32_t i=b*STAT_BLOCK ; i<end ; i++){
+                nlt += (x[i]<pivot);
+                ngt += (x[i]>pivot);
+            }
+            count[3*b] = nlt;
+            count[3*b+1] = end - b*STAT_BLOCK - nlt - ngt;
+            count[3*b+2] = ngt;
+        }
+        /* convert counts to positions of each block in buf */
+        uint_fast32_t nlt = 0, neq = 0;
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            nlt += count[3*b];
+            neq += count[3*b+1];
+        }
+        uint_fast32_t pos[3] = {0, nlt, nlt + neq};
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            for ( int j=0 ; j<3 ; j++){
+                const uint_fast32_t c = count[3*b+j];
+                count[3*b+j] = pos[j];
+                pos[j] += c;
+            }
+        }
+        /* place values */
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for ( uint_fast32_t b=0 ; b<nblock ; b++){
+            const uint_fast32_t end = (b+1<nblock) ? (b+1)*STAT_BLOCK : n;
+            uint_fast32_t plt = count[3*b], peq = count[3*b+1], pgt = count[3*b+2];
+            for ( uint_fast32_t i=b*STAT_BLOCK ; i<end ; i++){
+                if(x[i]<pivot){ buf[plt++] = x[i]; }
+                else if(x[i]>pivot){ buf[pgt++] = x[i]; }
+                else { buf[peq++] = x[i]; }
+            }
+        }
+
+        /* continue with range containing rank k, the buffers exchanging roles */
+        real_t * t = x; x = buf; buf = t;
+        if(k<nlt){ n = nlt; }
+        else if(k<nlt+neq){ ret = pivot; goto cleanup; }
+        else { x += nlt+neq; buf += nlt+neq; k -= nlt+neq; n -= nlt+neq; }
+    }
+    ret = select_serial(x,n,k);
+
+cleanup:
+    free(count);
+    return ret;
+}
+
+/** Smallest allowed value in x greater than v, and number of allowed values no greater than v. */
+static real_t min_above(const real_t * x, const bool * allowed, const uint_fast32_t n, const real_t v, uint_fast32_t * nle){
+    real_t minv = INFINITY;
+    uint_fast32_t count = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(min:minv) reduction(+:count) if(n>STAT_BLOCK)
+#endif
+    for ( uint_fast32_t i=0 ; i<n ; i++){
+        if(NULL!=allowed && !allowed[i]){ continue; }
+        if(x[i]>v){ minv = (x[i]<minv) ? x[i] : minv; }
+        else { count++; }
+    }
+    *nle = count;
+    return minv;
+}
+
+
+/* public functions */
+
+/** Compensated sum of allowed elements of x. */
+real_t sum( const real_t * x, const bool * allowed, const uint_fast32_t n){
+    if(NULL==x){return NAN;}
+    return reduce_terms(TERM_X,x,NULL,0.,allowed,n,NULL);
+}
+
+/**
+ * Median of allowed elements of x, by parallel selection; linear rather than sorting's n log(n).
+ * The mean of the two middle values for an even number of elements.
+ */
 real_t median( const real_t * x, const bool * allowed, const uint_fast32_t n){
    if(NULL==x){ return NAN;}
    if(0==n){ return NAN;}
 
-   real_t * xc = calloc(n,sizeof(double));
-   if(NULL==xc){ return NAN;}
+   const uint_fast32_t nblock = (n + STAT_BLOCK - 1) / STAT_BLOCK;
+   real_t * xc = malloc(2*n*sizeof(real_t));
+   uint_fast32_t * start = malloc(nblock*sizeof(uint_fast32_t));
+   real_t ret = NAN;
+   if(NULL==xc || NULL==start){ goto cleanup;}
 
+   /* copy allowed elements, each block from its position in the copy */
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static) if(nblock>1)
+#endif
+   for ( uint_fast32_t b=0 ; b<nblock ; b++){
+       const uint_fast32_t end = (b+1<nblock) ? (b+1)*STAT_BLOCK : n;
+       uint_fast32_t count = 0;
+       for ( uint_fast32_t i=b*STAT_BLOCK ; i<end ; i++){
+           count += (NULL==allowed) || allowed[i];
+       }
+       start[b] = count;
+   }
    uint_fast32_t nallowed = 0;
-   for ( int i=0 ; i<n ; i++){
-       if(NULL!=allowed && !allowed[i]){ continue; }
-       xc[nallowed] = x[i];
-       nallowed++;
+   for ( uint_fast32_t b=0 ; b<nblock ; b++){
+       const uint_fast32_t count = start[b];
+       start[b] = nallowed;
+       nallowed += count;
+   }
+   if(0==nallowed){ goto cleanup;}
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static) if(nblock>1)
+#endif
+   for ( uint_fast32_t b=0 ; b<nblock ; b++){
+       const uint_fast32_t end = (b+1<nblock) ? (b+1)*STAT_BLOCK : n;
+       uint_fast32_t pos = start[b];
+       for ( uint_fast32_t i=b*STAT_BLOCK ; i<end ; i++){
+           if(NULL!=allowed && !allowed[i]){ continue; }
+           xc[pos++] = x[i];
+       }
    }
-   qsort(xc,nallowed,sizeof(real_t),cmpReal);
 
-   int minIdx = (nallowed-1)/2;
-   real_t ret = isodd(nallowed)?xc[minIdx]:0.5*(xc[minIdx]+xc[minIdx+1]);
-   free(xc);
+   const uint_fast32_t minIdx = (nallowed-1)/2;
+   ret = select_parallel(xc,xc+nallowed,nallowed,minIdx);
+   if(!isodd(nallowed)){
+       /* next value is equal if repeated, else the smallest above; the copy has been reordered */
+       uint_fast32_t nle;
+       const real_t next = min_above(x,allowed,n,ret,&nle);
+       ret = 0.5*(ret + ((nle>minIdx+1) ? ret : next));
+   }
 
+cleanup:
+   free(start);
+   free(xc);
    return ret;
 }
 
     
-/*  Mean by compensated summation
+/*  Mean by compensated summation, in parallel blocks
  * See: http://en.wikipedia.org/wiki/Kahan_summation_algorithm
  */
 real_t mean( const real_t * x, const bool * allowed, const uint_fast32_t n){
     if(NULL==x){return NAN;}
    
     uint_fast32_t nallowed = 0; 
-    real_t sum = 0.0;
-    real_t c = 0.;
-    for ( uint_fast32_t i=0; i<n ; i++){
-        if(NULL!=allowed && !allowed[i]){ continue; }
-        volatile real_t y = x[i] - c;
-        volatile real_t t = sum + y;
-        c = (t-sum) - y;
-        sum = t;
-        nallowed++;
-    }
+    const real_t sum = reduce_terms(TERM_X,x,NULL,0.,allowed,n,&nallowed);
     return sum/nallowed;
 }
 
@@ -104,16 +385,7 @@ real_t meanxx( const real_t * x, const bool * allowed, const uint_fast32_t n){
     if(NULL==x){return NAN;}
    
     uint_fast32_t nallowed = 0; 
-    real_t sum = 0.0;
-    real_t c = 0.;
-    for ( uint_fast32_t i=0; i<n ; i++){
-        if(NULL!=allowed && !allowed[i]){ continue; }
-        volatile real_t y = x[i]*x[i] - c;
-        volatile real_t t = sum + y;
-        c = (t-sum) - y;
-        sum = t;
-        nallowed++;
-    }
+    const real_t sum = reduce_terms(TERM_XX,x,NULL,0.,allowed,n,&nallowed);
     return sum/nallowed;
 }
 
@@ -122,16 +394,7 @@ real_t meanxy( const real_t * x, const real_t * y, const bool * allowed, const u
     if(NULL==y){return NAN;}
     
     uint_fast32_t nallowed = 0;
-    real_t sum = 0.0;
-    real_t c = 0.;
-    for ( uint_fast32_t i=0; i<n ; i++){
-        if(NULL!=allowed && !allowed[i]){ continue; }
-        volatile real_t r = x[i]*y[i] - c;
-        volatile real_t t = sum + r;
-        c = (t-sum) - r;
-        sum = t;
-        nallowed++;
-    }
+    const real_t sum = reduce_terms(TERM_XY,x,y,0.,allowed,n,&nallowed);
     return sum/nallowed;
 }
 
@@ -195,23 +458,14 @@ real_t wmeanxy( const real_t * w, const real_t * x, const real_t * y, const bool
 }
 
 
-/* Variance by compensated summation
+/* Variance by compensated summation, in parallel blocks
  */
 real_t variance( const real_t * x, const bool * allowed, const uint_fast32_t n){
         if(NULL==x){return NAN;}
         
         const real_t m = mean(x,allowed,n);
         uint_fast32_t nallowed = 0;
-        real_t v = 0.0;
-        real_t c = 0.;
-        for ( uint_fast32_t i=0; i<n ; i++){
-            if(NULL!=allowed && !allowed[i]){ continue; }
-            volatile real_t y = (x[i] - m)*(x[i]-m) - c;
-            volatile real_t t = v + y;
-            c = (t-v) - y;
-            v = t;
-            nallowed++;
-        }
+        const real_t v = reduce_terms(TERM_DEV2,x,NULL,m,allowed,n,&nallowed);
         return v/(nallowed-1);
 }
 
@@ -356,9 +610,99 @@ real_t * iwlsLinearRegression(real_t (*f)(const real_t,const real_t), const real
 }
 
 #ifdef TEST
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+static const int NTHREAD_TEST = 4;              ///< Threads compared with a single thread.
+
+/** Kinds of test data for the selection and summation tests. */
+typedef enum TestDataT {DATA_DISTINCT, DATA_DUPLICATE, DATA_MASKED, DATA_MASKED_DUPLICATE, DATA_TENTHS, DATA_NUM} TESTDATA;
+static const char *TESTDATA_TEXT[] = {"distinct", "duplicates", "masked", "masked duplicates", "tenths"};
+
+/** Portable linear congruential generator, so test data is the same on every platform. */
+static uint32_t test_random(uint32_t * state){
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/** Fill x and allowed with n values of the selected kind; allowed is null unless masked. */
+static bool * fill_test_data(const TESTDATA kind, real_t * x, bool * allowed, const uint_fast32_t n){
+    uint32_t state = (uint32_t)n;
+    for ( uint_fast32_t i=0 ; i<n ; i++){
+        const uint32_t r = test_random(&state);
+        /*
+         * values of either sign spread over several orders of magnitude, so sums cancel,
+         * or a constant inexact value, whose rounding errors add up in a simple sum
+         */
+        x[i] = (kind==DATA_DUPLICATE || kind==DATA_MASKED_DUPLICATE) ? (real_t)(r % 5)
+               : (kind==DATA_TENTHS) ? 0.1
+               : ((r & 1) ? -1.0 : 1.0) * (1.0 + (r % 1000003)) * pow(10.0, (int)(r % 7) - 3);
+        allowed[i] = (test_random(&state) % 10) < 7;
+    }
+    return (kind==DATA_MASKED || kind==DATA_MASKED_DUPLICATE) ? allowed : NULL;
+}
+
+/** Return true if x and y are equal or both NaN. */
+static bool same_real(const real_t x, const real_t y){
+    return (x==y) || (isnan(x) && isnan(y));
+}
+
+/** Median of allowed elements by sorting a copy, and their sum and sum of magnitudes in long double. */
+static real_t reference_median(const real_t * x, const bool * allowed, const uint_fast32_t n, long double * sumref,
+                               long double * sumabs){
+    real_t * xc = calloc(n + 1, sizeof(real_t));
+    uint_fast32_t nallowed = 0;
+    long double err = 0.0L;
+    *sumref = 0.0L;
+    *sumabs = 0.0L;
+    for ( uint_fast32_t i=0 ; i<n ; i++){
+        if(NULL!=allowed && !allowed[i]){ continue; }
+        xc[nallowed++] = x[i];
+        /* compensated in long double, so error negligible against that of a double sum */
+        const long double t = *sumref + x[i];
+        err += (fabsl(*sumref)>=fabs(x[i])) ? (*sumref-t) + x[i] : (x[i]-t) + *sumref;
+        *sumref = t;
+        *sumabs += fabs(x[i]);
+    }
+    *sumref += err;
+    real_t ret = NAN;
+    if(nallowed>0){
+        qsort(xc,nallowed,sizeof(real_t),cmpReal);
+        const uint_fast32_t mid = (nallowed-1)/2;
+        ret = isodd(nallowed) ? xc[mid] : 0.5*(xc[mid] + xc[mid+1]);
+    }
+    free(xc);
+    return ret;
+}
+
+/** Test median and sum of n elements against sorting and long double, at one and several threads. */
+static void test_select_sum(const TESTDATA kind, const uint_fast32_t n){
+    real_t * x = calloc(n, sizeof(real_t));
+    bool * mask = calloc(n, sizeof(bool));
+    if(NULL==x || NULL==mask){ fputs("Failed to allocate test data\n",stdout); goto cleanup;}
+    const bool * allowed = fill_test_data(kind,x,mask,n);
+
+    long double sumref, sumabs;
+    const real_t medref = reference_median(x,allowed,n,&sumref,&sumabs);
+    real_t med[2], tot[2];
+    const int nthread[2] = {1, NTHREAD_TEST};
+    for ( int t=0 ; t<2 ; t++){
+        omp_set_num_threads(nthread[t]);
+        med[t] = median(x,allowed,n);
+        tot[t] = sum(x,allowed,n);
+    }
+
+    /* bound on the error of compensated summation, independent of n to first order */
+    const bool sumok = fabsl(tot[0] - sumref) <= (2 + n * DBL_EPSILON) * DBL_EPSILON * sumabs;
+    fprintf(stdout,"n = %6lu %-17s: median %s, sum %s, %d threads %s\n",(unsigned long)n,TESTDATA_TEXT[kind],
+            same_real(med[0],medref) ? "ok" : "wrong",sumok ? "ok" : "wrong",NTHREAD_TEST,
+            (same_real(med[0],med[1]) && same_real(tot[0],tot[1])) ? "agree" : "differ");
+cleanup:
+    free(mask);
+    free(x);
+}
+
 real_t * readmatrix( FILE * fp, int nrow, int ncol ){
     if(NULL==fp){ return NULL;}
     real_t * mat = calloc(nrow*ncol,sizeof(real_t));
@@ -378,8 +722,24 @@ real_t * readmatrix( FILE * fp, int nrow, int ncol ){
 }
         
 int main( int argc, char *argv[]){
+    if ( 1==argc){
+        /* counts either side of the block and serial selection sizes, odd and even */
+        const uint_fast32_t ntest[] = {1, 2, 7, 8, STAT_BLOCK - 1, STAT_BLOCK, STAT_BLOCK + 1,
+                                       SELECT_SERIAL - 1, SELECT_SERIAL, SELECT_SERIAL + 1, 100000, 100001};
+        fputs("* Median and compensated sum.\n",stdout);
+        for ( TESTDATA kind=0 ; kind<DATA_NUM ; kind++){
+            for ( unsigned int i=0 ; i<sizeof(ntest)/sizeof(*ntest) ; i++){
+                test_select_sum(kind,ntest[i]);
+            }
+        }
+        bool none[2] = {false, false};
+        const real_t x[2] = {1.0, 2.0};
+        fprintf(stdout,"Median with no allowed elements: %s\n",isnan(median(x,none,2)) ? "NaN, ok" : "not NaN");
+        return EXIT_SUCCESS;
+    }
+
     int nobs;
-    if ( 3!=argc){ fputs("Usage: wLR nobs filename\n",stderr); return EXIT_FAILURE;}
+    if ( 3!=argc){ fputs("Usage: test-statistics [nobs filename]\n",stderr); return EXIT_FAILURE;}
  
     FILE * fp = fopen(argv[2],"r");
     sscanf(argv[1],"%d",&nobs);
@@ -40,6 +40,21 @@
 
 /* private functions */
 
+/**
+ * Return the number of cycles required by a read.
+ * If use is supplied then this is the number flagged in its ncycle elements,
+ * otherwise ncycle itself, with zero meaning all available.
+ */
+static unsigned int required_cycles(const bool * use, const unsigned int ncycle) {
+
+    if (use == NULL) {return ncycle;}
+    unsigned int nreq = 0;
+    for (unsigned int cy = 0; cy < ncycle; cy++) {
+        if (use[cy]) {nreq++;}
+    }
+    return nreq;
+}
+
 /**
  * Create a tile from cif data.
  * Number of cycles required is specified, or zero means read all.
@@ -99,6 +114,62 @@ cleanup:
 }
 
 
+/** 
+ * Append the clusters of tilein onto tileout, selecting data columns. 
+ * tileout may be null or have an empty clusterlist, 
+ * in which case new clusters are created using details from tilein.
+ * Data columns are copied, or viewed without copying if view is set.
+ * See matrix() append_columns for error handling.
+ */
+static TILE append_TILE(TILE tileout, const TILE tilein, int colstart, int colend, const bool view){
+
+    /* validate parameters */
+    if(NULL==tilein) {return tileout;}
+    
+    if (NULL==tileout){
+        tileout = new_TILE();
+        if(NULL==tileout) {return NULL;}
+        tileout->lane = tilein->lane;
+        tileout->tile = tilein->tile;
+    }
+     
+    if (tileout->clusterlist == NULL) {   
+        /* append each cluster to null and create a new list */
+        LIST(CLUSTER) nodein = tilein->clusterlist;
+        CLUSTER clustout = NULL;
+        LIST(CLUSTER) listtail = NULL;;
+        while (nodein != NULL) {
+            clustout = view ? view_append_CLUSTER(clustout, nodein->elt, colstart, colend) :
+                              copy_append_CLUSTER(clustout, nodein->elt, colstart, colend);
+            if (tileout->clusterlist == NULL) {
+                tileout->clusterlist = cons_LIST(CLUSTER)(clustout, tileout->clusterlist);
+                listtail = tileout->clusterlist;
+            }
+            else {
+                listtail = rcons_LIST(CLUSTER)(clustout, listtail);
+            }
+            tileout->ncluster++;
+            nodein = nodein->nxt;
+            clustout = NULL;
+        }    
+    }
+    else {
+        /* append each cluster in list */
+        LIST(CLUSTER) nodein = tilein->clusterlist;
+        LIST(CLUSTER) nodeout = tileout->clusterlist;
+        while ((nodein != NULL) && (nodeout != NULL)) {
+            nodeout->elt = view ? view_append_CLUSTER(nodeout->elt, nodein->elt, colstart, colend) :
+                                  copy_append_CLUSTER(nodeout->elt, nodein->elt, colstart, colend);
+            nodein = nodein->nxt;
+            nodeout = nodeout->nxt;
+        }
+    }
+    tileout->ncycle += colend - colstart + 1;
+    
+    /* hmhm any error checking required?? */
+    return tileout;
+}
+
 /* public functions */
 
 /*
@@ -175,7 +246,7 @@ TILE coerce_TILE_from_array(unsigned int ncluster, unsigned int ncycle, int_t *
 
     /* read in remaining clusters, appending to tail of cluster list */
     listtail = tile->clusterlist;
-    for (int idx = 1; idx < ncluster; idx++) {
+    for (unsigned int idx = 1; idx < ncluster; idx++) {
         cl = coerce_CLUSTER_from_array(ncycle, next_x, &next_x);
         if (NULL==cl){ goto cleanup;}
         listtail = rcons_LIST(CLUSTER)(cl, listtail);
@@ -189,76 +260,130 @@ cleanup:
 }
 
 /** 
- * Append the clusters of tilein onto tileout, selecting data columns. 
- * tileout may be null or have an empty clusterlist, 
- * in which case new clusters are created using details from tilein.
- * See matrix() append_columns for error handling.
+ * Append the clusters of tilein onto tileout, copying the selected data columns. 
+ * See append_TILE.
  */
 TILE copy_append_TILE(TILE tileout, const TILE tilein, int colstart, int colend){
+    return append_TILE(tileout, tilein, colstart, colend, false);
+}
+
+/** 
+ * Append the clusters of tilein onto tileout as views of the selected data columns. 
+ * Intensities are not copied unless the columns do not follow on from those already viewed.
+ * tilein must not be freed while tileout is in use. See append_TILE.
+ */
+TILE view_append_TILE(TILE tileout, const TILE tilein, int colstart, int colend){
+    return append_TILE(tileout, tilein, colstart, colend, true);
+}
+
+/**
+ * Append copies of an evenly spaced sample of nsample clusters from tilein onto tileout.
+ * Clusters are held in file (position) order so the sample is stratified across the tile.
+ * All clusters are copied if nsample is zero or more than the number available.
+ * tileout may be empty, in which case it is created with the lane, tile and cycles of tilein.
+ * Returns tileout unchanged if tilein is null or the number of cycles differs.
+ * Returns NULL if tileout is empty and create fails.
+ */
+TILE sample_append_TILE(TILE tileout, const TILE tilein, unsigned int nsample){
 
     /* validate parameters */
     if(NULL==tilein) {return tileout;}
-    
+
     if (NULL==tileout){
         tileout = new_TILE();
         if(NULL==tileout) {return NULL;}
         tileout->lane = tilein->lane;
         tileout->tile = tilein->tile;
+        tileout->ncycle = tilein->ncycle;
     }
-     
-    if (tileout->clusterlist == NULL) {   
-        /* append each cluster to null and create a new list */
-        LIST(CLUSTER) nodein = tilein->clusterlist;
-        CLUSTER clustout = NULL;
-        LIST(CLUSTER) listtail = NULL;;
-        while (nodein != NULL) {
-            clustout = copy_append_CLUSTER(clustout, nodein->elt, colstart, colend);
-            if (tileout->clusterlist == NULL) {
-                tileout->clusterlist = cons_LIST(CLUSTER)(clustout, tileout->clusterlist);
+    if (tileout->ncycle != tilein->ncycle) {return tileout;}
+
+    const unsigned int ncluster = tilein->ncluster;
+    if ((nsample == 0) || (nsample > ncluster)) {nsample = ncluster;}
+
+    /* find end of existing list */
+    LIST(CLUSTER) listtail = tileout->clusterlist;
+    while ((listtail != NULL) && (listtail->nxt != NULL)) {
+        listtail = listtail->nxt;
+    }
+
+    /* take the cluster at the centre of each of nsample equal strata */
+    LIST(CLUSTER) nodein = tilein->clusterlist;
+    unsigned int ns = 0;
+    for (unsigned int cl = 0; (nodein != NULL) && (ns < nsample); cl++) {
+        const unsigned int pick = ((2 * (uint64_t)ns + 1) * ncluster) / (2 * (uint64_t)nsample);
+        if (cl == pick) {
+            CLUSTER clustout = copy_CLUSTER(nodein->elt);
+            if (clustout == NULL) {break;}
+            if (listtail == NULL) {
+                tileout->clusterlist = cons_LIST(CLUSTER)(clustout, NULL);
                 listtail = tileout->clusterlist;
             }
             else {
                 listtail = rcons_LIST(CLUSTER)(clustout, listtail);
             }
             tileout->ncluster++;
-            nodein = nodein->nxt;
-            clustout = NULL;
-        }    
-    }
-    else {
-        /* append each cluster in list */
-        LIST(CLUSTER) nodein = tilein->clusterlist;
-        LIST(CLUSTER) nodeout = tileout->clusterlist;
-        while ((nodein != NULL) && (nodeout != NULL)) {
-            nodeout->elt = copy_append_CLUSTER(nodeout->elt, nodein->elt, colstart, colend);
-            nodein = nodein->nxt;
-            nodeout = nodeout->nxt;
+            ns++;
         }
+        nodein = nodein->nxt;
     }
-    tileout->ncycle += colend - colstart + 1;
-    
-    /* hmhm any error checking required?? */
+
     return tileout;
 }
 
+/**
+ * Keep only the clusters of a tile from first to last inclusive, counting from zero,
+ * freeing the others. The order of the clusters kept is unchanged.
+ * Returns the tile, which has no clusters if first is beyond its last cluster.
+ */
+TILE range_TILE(TILE tile, const unsigned int first, const unsigned int last){
+
+    if(NULL==tile) {return NULL;}
+
+    /* free the clusters before the range */
+    LIST(CLUSTER) node = tile->clusterlist;
+    for (unsigned int cl = 0; (cl < first) && (NULL!=node); cl++) {
+        LIST(CLUSTER) nxt = node->nxt;
+        node->nxt = NULL;
+        free_LIST(CLUSTER)(node);
+        node = nxt;
+    }
+    tile->clusterlist = node;
+    tile->ncluster = 0;
+
+    /* count those kept and free any after the range */
+    for (unsigned int cl = first; NULL!=node; cl++) {
+        tile->ncluster++;
+        if (cl == last) {
+            free_LIST(CLUSTER)(node->nxt);
+            node->nxt = NULL;
+            break;
+        }
+        node = node->nxt;
+    }
+    return tile;
+}
+
 /**
  * Read a tile from a cif file.
  * Returns a new TILE containing a list of clusters, in the same order as file.
+ * If use is supplied then only the cycles it flags out of the first ncycle are stored,
+ * consecutively, otherwise ncycle is the number of cycles required, or zero means read all.
  */
-TILE read_cif_TILE(XFILE * fp, unsigned int ncycle) {
+TILE read_cif_TILE(XFILE * fp, const bool * use, unsigned int ncycle) {
     CIFDATA cif = NULL;
     TILE tile = NULL;
 
     if(NULL==fp) {return NULL;}
 
-    /* read in all the cif data */
-    cif = readCIFfromStream(fp);
+    /* read in the cif data for the cycles used */
+    cif = readCIFcyclesfromStream(fp, use, ncycle);
 
     if(NULL==cif){
         warnx("Failed to read cif tile.");
     }
     else {
-        tile = create_TILE_from_cif(cif, ncycle);
+        tile = create_TILE_from_cif(cif, required_cycles(use, ncycle));
     }
 
     free_cif(cif);
@@ -298,21 +423,29 @@ void add_coordinates_to_tile(TILE tile, const char *root, const unsigned int lan
 /**
  * Read a tile from a cif run-folder.
  * Returns a new TILE containing a list of clusters, in the same order as files.
+ * If use is supplied then only the cycle files it flags out of the first ncycle are read
+ * and stored consecutively, otherwise ncycle is the number of cycles required, or zero means read all.
  */
-TILE read_folder_TILE(const char *root, const unsigned int laneNum, const unsigned int tileNum, unsigned int ncycle) {
+TILE read_folder_TILE(const char *root, const unsigned int laneNum, const unsigned int tileNum,
+                      const bool * use, unsigned int ncycle) {
     CIFDATA cif = NULL;
     TILE tile = NULL;
 
     if (NULL==root) {return NULL;}
     
-    cif = readCIFfromDir(root, laneNum, tileNum, XFILE_RAW);
+    if (use == NULL) {
+        cif = readCIFfromDir(root, laneNum, tileNum, XFILE_RAW);
+    }
+    else {
+        cif = readCIFcyclesfromDir(root, laneNum, tileNum, XFILE_RAW, use, ncycle);
+    }
 
     if(NULL==cif){
         warnx("Failed to read tile from run-folder; lane number %u tile number %u.", laneNum, tileNum);
     }
     else {
         xfprintf(xstderr, "Information: Run-folder data found; lane number %u tile number %u\n", laneNum, tileNum);
-        tile = create_TILE_from_cif(cif, ncycle);
+        tile = create_TILE_from_cif(cif, required_cycles(use, ncycle));
 	add_coordinates_to_tile(tile,root,laneNum,tileNum);
         /* store lane and tile since we have them */
         tile->lane = laneNum;
@@ -323,6 +456,41 @@ TILE read_folder_TILE(const char *root, const unsigned int laneNum, const unsign
     return tile;
 }
 
+/**
+ * Append the cycles of a run-folder tile flagged by use, out of the first ncycle, onto tile.
+ * Flagged cycles are read in order up to the first whose cycle file is not yet present,
+ * so a run-folder still being written can be read a few cycles at a time.
+ * tile may be null, in which case it is created. Returns tile unchanged if no new cycles
+ * were read or their number of clusters differs.
+ */
+TILE append_folder_TILE(TILE tile, const char *root, const unsigned int laneNum, const unsigned int tileNum,
+                        const bool * use, unsigned int ncycle) {
+
+    if ((NULL==root) || (NULL==use)) {return tile;}
+
+    CIFDATA cif = readCIFcyclesfromDir(root, laneNum, tileNum, XFILE_RAW, use, ncycle);
+    if ((NULL!=cif) && (cif_get_ncycle(cif) > 0)) {
+        TILE newtile = create_TILE_from_cif(cif, cif_get_ncycle(cif));
+        if (NULL==tile) {
+            tile = newtile;
+            if (NULL!=tile) {
+                add_coordinates_to_tile(tile,root,laneNum,tileNum);
+                tile->lane = laneNum;
+                tile->tile = tileNum;
+            }
+        }
+        else {
+            if ((NULL!=newtile) && (newtile->ncluster == tile->ncluster)) {
+                tile = copy_append_TILE(tile, newtile, 0, newtile->ncycle - 1);
+            }
+            free_TILE(newtile);
+        }
+    }
+
+    free_cif(cif);
+    return tile;
+}
+
 /**
  * Read a tile from an Illumina int.txt file.
  * Returns a list of clusters, in reverse order compared to file.
@@ -410,7 +578,9 @@ void write_lane_tile(XFILE * fp, const TILE tile) {
 
 #ifdef TEST
 #include <err.h>
+#include <unistd.h>
 #include "dirio.h"          // for lanetile
+#include "nuc.h"            // for NBASE
 
 static const unsigned int NXCAT = 4;
 static const unsigned int NYCAT = 4;
@@ -505,6 +675,12 @@ int main ( int argc, char * argv[]){
     show_TILE(xstdout, tile2, 10);
     free_TILE(tile2);
 
+    xfputs("Sample tile, twice onto same\n", xstdout);
+    tile2 = sample_append_TILE(NULL, tile_fwd, 3);
+    tile2 = sample_append_TILE(tile2, tile_fwd, 2);
+    show_TILE(xstdout, tile2, 10);
+    free_TILE(tile2);
+
     /* optional cif file testing */
     if (argc > 3) {
         XFILE * fpcif = xfopen(argv[3], XFILE_UNKNOWN, "r");
@@ -513,7 +689,7 @@ int main ( int argc, char * argv[]){
         }
 
         xfputs("Read null cif file\n", xstdout);
-        TILE tile_cif = read_cif_TILE(NULL, ncycle);
+        TILE tile_cif = read_cif_TILE(NULL, NULL, ncycle);
         if (tile_cif==NULL) {
             xfputs("Return value null, ok\n", xstdout);
         }
@@ -524,7 +700,7 @@ int main ( int argc, char * argv[]){
     
         xfputs("Read not a cif file\n", xstdout);
         fp = xfopen(argv[2], XFILE_UNKNOWN, "r");
-        tile_cif = read_cif_TILE(fp, ncycle);
+        tile_cif = read_cif_TILE(fp, NULL, ncycle);
         xfclose(fp);
         if (tile_cif==NULL) {
             xfputs("Return value null, ok\n", xstdout);
@@ -535,7 +711,7 @@ int main ( int argc, char * argv[]){
         }
     
         xfputs("Too many cycles tile from cif file\n", xstdout);
-        tile_cif = read_cif_TILE(fpcif, 9999);
+        tile_cif = read_cif_TILE(fpcif, NULL, 9999);
         xfclose(fpcif);
         if (tile_cif==NULL) {
             errx(EXIT_FAILURE, "Failed to read supplied cif file");
@@ -546,17 +722,80 @@ int main ( int argc, char * argv[]){
     
         xfputs("Read all cycles tile from cif file\n", xstdout);
         fpcif = xfopen(argv[3], XFILE_UNKNOWN, "r");
-        tile_cif = read_cif_TILE(fpcif, 0);
+        tile_cif = read_cif_TILE(fpcif, NULL, 0);
         xfclose(fpcif);
         xfprintf(xstdout, "Available cycles: %u\n", tile_cif->ncycle);
         tile_cif = free_TILE(tile_cif);
 
         xfputs("Read tile from cif file\n", xstdout);
         fpcif = xfopen(argv[3], XFILE_UNKNOWN, "r");
-        tile_cif = read_cif_TILE(fpcif, ncycle);
+        tile_cif = read_cif_TILE(fpcif, NULL, ncycle);
         xfclose(fpcif);
         show_TILE(xstdout, tile_cif, 10);
         free_TILE(tile_cif);
+
+        xfputs("Read alternate cycles tile from cif file\n", xstdout);
+        bool * use = calloc(ncycle, sizeof(*use));
+        for (unsigned int cy = 0; cy < ncycle; cy++) {
+            use[cy] = (cy % 2 == 0);
+        }
+        fpcif = xfopen(argv[3], XFILE_UNKNOWN, "r");
+        tile_cif = read_cif_TILE(fpcif, use, ncycle);
+        xfclose(fpcif);
+        show_TILE(xstdout, tile_cif, 10);
+        free_TILE(tile_cif);
+
+        /* compressed streams count bytes rather than values read */
+        xfputs("Read alternate cycles from gzip cif file\n", xstdout);
+        char gzname[] = "/tmp/test-tile-XXXXXX";
+        const int fd = mkstemp(gzname);
+        CIFDATA cif = readCIFfromFile(argv[3], XFILE_UNKNOWN);
+        bool agree = (fd >= 0) && (NULL != cif) && writeCIFtoFile(cif, gzname, XFILE_GZIP);
+        free_cif(cif);
+        fpcif = xfopen(argv[3], XFILE_UNKNOWN, "r");
+        CIFDATA cifraw = readCIFcyclesfromStream(fpcif, use, ncycle);
+        xfclose(fpcif);
+        fpcif = xfopen(gzname, XFILE_GZIP, "r");
+        CIFDATA cifgz = readCIFcyclesfromStream(fpcif, use, ncycle);
+        xfclose(fpcif);
+        agree = agree && (NULL != cifraw) && (NULL != cifgz)
+                && (cif_get_ncycle(cifraw) == cif_get_ncycle(cifgz))
+                && (memcmp(cif_get_const_intensities(cifraw).i8, cif_get_const_intensities(cifgz).i8,
+                           (size_t)NBASE * cif_get_ncycle(cifraw) * cif_get_ncluster(cifraw)
+                           * cif_get_datasize(cifraw)) == 0);
+        xfprintf(xstdout, "Same as uncompressed: %s\n", agree ? "yes" : "no");
+        free_cif(cifraw);
+        free_cif(cifgz);
+        if (fd >= 0) {
+            close(fd);
+            remove(gzname);
+        }
+        xfree(use);
+
+        /* a partly written file fails to read rather than leaving values zero */
+        xfputs("Read truncated cif file\n", xstdout);
+        char cutname[] = "/tmp/test-tile-XXXXXX";
+        const int fdcut = mkstemp(cutname);
+        FILE * fin = fopen(argv[3], "rb");
+        FILE * fout = (fdcut >= 0) ? fdopen(fdcut, "wb") : NULL;
+        if ((NULL != fin) && (NULL != fout)) {
+            char buf[BUFSIZ];
+            size_t n, total = 0;
+            while ((n = fread(buf, 1, sizeof(buf), fin)) > 0) {
+                fwrite(buf, 1, n, fout);
+                total += n;
+            }
+            fflush(fout);
+            if (ftruncate(fdcut, total - 1) != 0) {
+                errx(EXIT_FAILURE, "Failed to truncate cif copy");
+            }
+        }
+        if (NULL != fin) {fclose(fin);}
+        if (NULL != fout) {fclose(fout);}
+        cif = readCIFfromFile(cutname, XFILE_RAW);
+        xfputs((cif == NULL) ? "Return value null, ok\n" : "Return value not null, not ok\n", xstdout);
+        free_cif(cif);
+        remove(cutname);
     }
     else {
         xfputs("Skip cif file tests\n", xstdout);
@@ -565,7 +804,7 @@ int main ( int argc, char * argv[]){
     /* optional cif run-folder testing */
     if (argc > 4) {
         xfputs("Read null cif run-folder\n", xstdout);
-        TILE tile_fol = read_folder_TILE(NULL, 1, 1, ncycle);
+        TILE tile_fol = read_folder_TILE(NULL, 1, 1, NULL, ncycle);
         if (tile_fol==NULL) {
             xfputs("Return value null, ok\n", xstdout);
         }
@@ -575,7 +814,7 @@ int main ( int argc, char * argv[]){
         }
     
         xfputs("Read not a cif run-folder\n", xstdout);
-        tile_fol = read_folder_TILE("xxxx", 1, 1, ncycle);
+        tile_fol = read_folder_TILE("xxxx", 1, 1, NULL, ncycle);
         if (tile_fol==NULL) {
             xfputs("Return value null, ok\n", xstdout);
         }
@@ -585,7 +824,7 @@ int main ( int argc, char * argv[]){
         }
     
         xfputs("Invalid lane from cif run-folder (> 9)\n", xstdout);
-        tile_fol = read_folder_TILE("xxxx", 10, 1, ncycle);
+        tile_fol = read_folder_TILE("xxxx", 10, 1, NULL, ncycle);
         if (tile_fol==NULL) {
             xfputs("Return value null, ok\n", xstdout);
         }
@@ -595,7 +834,7 @@ int main ( int argc, char * argv[]){
         }
     
         xfputs("Invalid tile from cif run-folder (> 9999)\n", xstdout);
-        tile_fol = read_folder_TILE("xxxx", 1, 10000, ncycle);
+        tile_fol = read_folder_TILE("xxxx", 1, 10000, NULL, ncycle);
         if (tile_fol==NULL) {
             xfputs("Return value null, ok\n", xstdout);
         }
@@ -618,7 +857,7 @@ int main ( int argc, char * argv[]){
                         more = false;
                     }
                     else {
-                        tile_fol = read_folder_TILE(argv[4], lanetile.lane, lanetile.tile, ncycle);
+                        tile_fol = read_folder_TILE(argv[4], lanetile.lane, lanetile.tile, NULL, ncycle);
                         if (tile_fol==NULL) {
                             xfprintf(xstdout, "Lane %u tile %u not available\n", lanetile.lane, lanetile.tile);
                         }
@@ -658,6 +897,16 @@ int main ( int argc, char * argv[]){
     tile_fwd = copy_append_TILE(tile_fwd, tile1, 1, ncycle/2);    
     show_TILE(xstdout,tile_fwd,10);
 
+    fputs("View append to null, from second column (1) to ncol/2, then following columns to ncol-1\n",stdout);
+    TILE tile_view = view_append_TILE(NULL, tile1, 1, ncycle/2);
+    tile_view = view_append_TILE(tile_view, tile1, ncycle/2 + 1, ncycle - 1);
+    show_TILE(xstdout,tile_view,10);
+
+    fputs("View append first column (0), not following so copied\n",stdout);
+    tile_view = view_append_TILE(tile_view, tile1, 0, 0);
+    show_TILE(xstdout,tile_view,10);
+    tile_view = free_TILE(tile_view);
+
     xfputs("Create an array\n", xstdout);
     unsigned int ncl = 0;
     unsigned int matsize = tile1->clusterlist->elt->signals->nrow * ncycle;
@@ -697,21 +946,21 @@ int main ( int argc, char * argv[]){
     /* do not free tile_ary as it points to arry */
 
     xfputs("Create list pointer array\n", xstdout);
-    unsigned int nelt = ncluster - 1;
+    size_t nelt = ncluster - 1;
     LIST(CLUSTER) * list_ary = array_from_list_CLUSTER(tile_ary->clusterlist, &nelt);
-    xfprintf(xstdout, "Number found for list array asking for too few: %u (available %u)\n", nelt, ncluster);
+    xfprintf(xstdout, "Number found for list array asking for too few: %zu (available %u)\n", nelt, ncluster);
     free_array_list_CLUSTER(list_ary);
 
     nelt = ncluster + 1;
     list_ary = array_from_list_CLUSTER(tile_ary->clusterlist, &nelt);
-    xfprintf(xstdout, "Number found for list array asking for too many: %u (available %u)\n", nelt, ncluster);
+    xfprintf(xstdout, "Number found for list array asking for too many: %zu (available %u)\n", nelt, ncluster);
     free_array_list_CLUSTER(list_ary);
     
     nelt = 0;
     list_ary = array_from_list_CLUSTER(tile_ary->clusterlist, &nelt);
-    xfprintf(xstdout, "Number found for list array asking for all: %u (available %u)\n", nelt, ncluster);
-    for ( int i=0 ; i<nelt ; i++) {
-        xfprintf(xstdout, "Index %d: ", i);
+    xfprintf(xstdout, "Number found for list array asking for all: %zu (available %u)\n", nelt, ncluster);
+    for ( size_t i=0 ; i<nelt ; i++) {
+        xfprintf(xstdout, "Index %zu: ", i);
         show_CLUSTER(xstdout, list_ary[i]->elt);
     }
     free_array_list_CLUSTER(list_ary);
@@ -724,7 +973,7 @@ int main ( int argc, char * argv[]){
     LIST(CLUSTER) * spots = split_list_CLUSTER(whichquad,tile1->clusterlist,NXCAT*NYCAT,NULL);
     for ( int i=0 ; i<NXCAT ; i++){
         for ( int j=0 ; j<NYCAT ; j++){
-            fprintf(stdout,"(%d,%d) has %u elements\n",i+1,j+1,length_LIST(CLUSTER)(spots[i*NYCAT+j]));
+            fprintf(stdout,"(%d,%d) has %zu elements\n",i+1,j+1,length_LIST(CLUSTER)(spots[i*NYCAT+j]));
             //show_LIST(CLUSTER)(xstdout,spots[i*NYCAT+j],10);
             shallow_free_list_CLUSTER(spots[i*NYCAT+j]);
         }
@@ -48,12 +48,20 @@ void show_TILE(XFILE * fp, const TILE tile, const unsigned int n);
 // standard variations
 TILE coerce_TILE_from_array(unsigned int ncluster, unsigned int ncycle, int_t * x);
 TILE copy_append_TILE(TILE tileout, const TILE tilein, int colstart, int colend);
+TILE view_append_TILE(TILE tileout, const TILE tilein, int colstart, int colend);
+TILE sample_append_TILE(TILE tileout, const TILE tilein, unsigned int nsample);
+TILE range_TILE(TILE tile, const unsigned int first, const unsigned int last);
 
 // Read a tile from a cif file.
-TILE read_cif_TILE(XFILE * fp, unsigned int ncycle);
+TILE read_cif_TILE(XFILE * fp, const bool * use, unsigned int ncycle);
 
 // Read a tile from a cif run-folder.
-TILE read_folder_TILE(const char *root, const unsigned int nlane, const unsigned int ntile, unsigned int ncycle);
+TILE read_folder_TILE(const char *root, const unsigned int nlane, const unsigned int ntile,
+                      const bool * use, unsigned int ncycle);
+
+// Append cycles to a tile from a run-folder still being written.
+TILE append_folder_TILE(TILE tile, const char *root, const unsigned int nlane, const unsigned int ntile,
+                        const bool * use, unsigned int ncycle);
 
 // Read tile from file in Illumina int.txt format, reverse order
 TILE read_known_TILE(XFILE * fp, unsigned int ncycle) __attribute__((deprecated));
@@ -107,3 +107,22 @@ int match_string(const char *string, const char *match[], int num) {
     }
     return result;
 }
+
+/** Return the name of the code path selected for HOT_KERNEL functions on this cpu. */
+const char * kernel_code_path(void) {
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(NOCLONES)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return "avx512f";
+    }
+    else if (__builtin_cpu_supports("avx2")) {
+        return "avx2";
+    }
+    else {
+        return "sse2";
+    }
+#else
+    return "generic";
+#endif
+}
@@ -5,6 +5,7 @@
  *   - xfree
  *   - validate
  *   - USEFLOAT switch
+ *   - HOT_KERNEL dispatch
  *   - CSTRING; a simple string type
  *//*
  *  Created : 16 Mar 2010
@@ -75,6 +76,18 @@ static inline void xfree( void * ptr){ if(NULL!=ptr){ free(ptr);} }
     #define HUGE_VALR HUGE_VAL
 #endif
 
+/**
+ * Compile a hot kernel for several instruction sets, the version for the running cpu
+ * being selected when the program is loaded. Needs gcc with ifunc support on x86-64;
+ * define NOCLONES to build a single version only.
+ * Build with -ffp-contract=off so every version gives identical results.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(NOCLONES)
+    #define HOT_KERNEL __attribute__((target_clones("avx512f","avx2","default")))
+#else
+    #define HOT_KERNEL
+#endif
+
 /** General 3-way return option. */
 typedef enum RetOptT {E_CONTINUE, E_FAIL, E_STOP} RETOPT;
 
@@ -90,5 +103,7 @@ void show_CSTRING(FILE *fp, const CSTRING cstr);
 /* General string utilities */
 int match_string(const char *string, const char *match[], int num);
 
+const char * kernel_code_path(void);
+
 #endif /* _UTILITY_H */
 
@@ -63,6 +63,7 @@ struct _xfile_struct {
 
 const char * GZ = "gz";
 const char * BZ2 = "bz2";
+static const size_t XIO_CHUNK = 1 << 30;    ///< Largest transfer in one call of the compression libraries.
 
 /* members */
 
@@ -118,6 +119,39 @@ static int BZ2_bzvprintf ( BZFILE * bzfp, const char * fmt, va_list args ){
     return ret;                                             
 }
 
+/**
+ * Read up to nbyte bytes from a compressed file.
+ * The compression libraries take an int length so large blocks are read in pieces.
+ * Returns number of bytes read.
+ */
+static size_t xfread_compressed(XFILE * fp, char * ptr, const size_t nbyte){
+    size_t ret = 0;
+    while (ret < nbyte) {
+        const unsigned int len = (nbyte - ret > XIO_CHUNK) ? XIO_CHUNK : nbyte - ret;
+        const int retz = (XFILE_GZIP == fp->mode) ? gzread(fp->ptr.zfh, ptr + ret, len)
+                                                 : BZ2_bzread(fp->ptr.bzfh, ptr + ret, len);
+        if (retz <= 0) {break;}
+        ret += retz;
+    }
+    return ret;
+}
+
+/**
+ * Write nbyte bytes to a compressed file, in pieces as for xfread_compressed.
+ * Returns number of bytes written.
+ */
+static size_t xfwrite_compressed(XFILE * fp, const char * ptr, const size_t nbyte){
+    size_t ret = 0;
+    while (ret < nbyte) {
+        const unsigned int len = (nbyte - ret > XIO_CHUNK) ? XIO_CHUNK : nbyte - ret;
+        const int retz = (XFILE_GZIP == fp->mode) ? gzwrite(fp->ptr.zfh, ptr + ret, len)
+                                                 : BZ2_bzwrite(fp->ptr.bzfh, (void *)(ptr + ret), len);
+        if (retz <= 0) {break;}
+        ret += retz;
+    }
+    return ret;
+}
+
 /** Return true if selected file pointer is not null. */
 static int xnotnull_file(XFILE * fp){
     switch( fp->mode ){
@@ -225,15 +259,12 @@ size_t xfread(void *ptr, size_t size, size_t nmemb, XFILE *fp){
 	if (NULL==fp) { return 0;}
 	if (NULL==ptr) { return 0;}
     size_t ret = 0;
-    int retz = 0;
 
     switch( fp->mode ){
     	case XFILE_UNKNOWN:
         case XFILE_RAW:   ret = fread(ptr,size,nmemb,fp->ptr.fh); break;
-        case XFILE_GZIP:  retz = gzread(fp->ptr.zfh,ptr,size*nmemb);
-                          if (retz>0) {ret = retz;} break;
-        case XFILE_BZIP2: retz = BZ2_bzread(fp->ptr.bzfh,ptr,size*nmemb);
-                          if (retz>0) {ret = retz;} break;
+        case XFILE_GZIP:
+        case XFILE_BZIP2: ret = xfread_compressed(fp,ptr,size*nmemb); break;
     }
 
     return ret; 
@@ -248,16 +279,13 @@ size_t xfwrite(const void * restrict ptr, const size_t size, const size_t nmemb,
 	if (NULL==fp) { return 0;}
 	if (NULL==ptr) { return 0;}
     size_t ret = 0;
-    int retz = 0;
 
     switch( fp->mode ){
     	case XFILE_UNKNOWN:
         case XFILE_RAW:   ret = fwrite(ptr,size,nmemb,fp->ptr.fh); break;
-        case XFILE_GZIP:  retz = gzwrite(fp->ptr.zfh,ptr,size*nmemb);
-                          if (retz>0) {ret = retz;} break;
-        case XFILE_BZIP2: retz = BZ2_bzwrite(fp->ptr.bzfh,(void*)ptr,size*nmemb);
-                          if (retz>0) {ret = retz;} break;
-    }       
+        case XFILE_GZIP:
+        case XFILE_BZIP2: ret = xfwrite_compressed(fp,ptr,size*nmemb); break;
+    }
 
     return ret;
 }